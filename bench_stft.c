@@ -0,0 +1,190 @@
+/**
+ * @file bench_stft.c
+ * @brief Cycle-level STFT benchmark harness (see `make bench`).
+ *
+ * Runs a matrix of hop/win/window-type shapes and times each stage of
+ * the frame loop separately (gather+window, FFT, spectrum unpack) with
+ * CLOCK_MONOTONIC, reporting median and p99 ns per frame plus frames/s.
+ *
+ * Output is machine-readable CSV on stdout (comment lines start with
+ * '#') so CI can diff runs:
+ *
+ *   win,fftsize,hop,wintype,stage,samples,median_ns,p99_ns,frames_per_sec
+ *
+ * Built at -O2 via the dedicated `bench_stft` Makefile target — numbers
+ * from the -O0 test build are not comparable.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "stft.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+/** @brief Number of timed frame samples collected per shape. */
+#define BENCH_SAMPLES 2048
+
+/** @brief Untimed warmup frames per shape (page in buffers and tables). */
+#define BENCH_WARMUP 128
+
+/** @brief Monotonic timestamp in nanoseconds. */
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/** @brief Percentile of a sorted sample array. */
+static uint64_t percentile(const uint64_t *sorted, size_t n, double p) {
+    size_t idx = (size_t)(p * (double)(n - 1) + 0.5);
+    return sorted[idx];
+}
+
+static const char *wintype_name(WinType type) {
+    switch (type) {
+    case HANNING:
+        return "hanning";
+    case HAMMING:
+        return "hamming";
+    case BLACKMAN:
+        return "blackman";
+    case BLACKMAN_HARRIS:
+        return "blackman_harris";
+    }
+    return "unknown";
+}
+
+/** @brief Emit one CSV row for a stage's sorted per-frame samples. */
+static void report(const STFT_Config_t *config, WinType type,
+                   const char *stage, uint64_t *samples, size_t n) {
+    qsort(samples, n, sizeof(uint64_t), cmp_u64);
+    uint64_t median = percentile(samples, n, 0.50);
+    uint64_t p99 = percentile(samples, n, 0.99);
+    double fps = (median > 0) ? 1e9 / (double)median : 0.0;
+    printf("%zu,%zu,%zu,%s,%s,%zu,%llu,%llu,%.0f\n", config->win,
+           config->fftsize, config->hop, wintype_name(type), stage, n,
+           (unsigned long long)median, (unsigned long long)p99, fps);
+}
+
+/**
+ * @brief Benchmark one shape: per-stage and whole-frame timings.
+ *
+ * Replays the stft_compute frame loop stage by stage so each phase can
+ * be timed in isolation; the "frame" row is a separate end-to-end
+ * measurement, not the sum of the stage medians.
+ */
+static int bench_shape(size_t hop, size_t win, WinType type) {
+    const size_t insize = win + hop * (BENCH_SAMPLES + BENCH_WARMUP);
+
+    STFT_Config_t *config = stft_config_init(hop, win, insize, type, STFT_FFT);
+    if (!config) {
+        fprintf(stderr, "config init failed for win=%zu hop=%zu\n", win, hop);
+        return -1;
+    }
+
+    float *input = (float *)malloc(insize * sizeof(float));
+    Complex_t *row =
+        (Complex_t *)malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
+    uint64_t *t_gather = (uint64_t *)malloc(BENCH_SAMPLES * sizeof(uint64_t));
+    uint64_t *t_fft = (uint64_t *)malloc(BENCH_SAMPLES * sizeof(uint64_t));
+    uint64_t *t_unpack = (uint64_t *)malloc(BENCH_SAMPLES * sizeof(uint64_t));
+    uint64_t *t_frame = (uint64_t *)malloc(BENCH_SAMPLES * sizeof(uint64_t));
+    if (!input || !row || !t_gather || !t_fft || !t_unpack || !t_frame) {
+        fprintf(stderr, "allocation failed for win=%zu hop=%zu\n", win, hop);
+        free(input);
+        free(row);
+        free(t_gather);
+        free(t_fft);
+        free(t_unpack);
+        free(t_frame);
+        stft_config_deinit(config);
+        return -1;
+    }
+
+    for (size_t i = 0; i < insize; i++) {
+        float t = (float)i / 8000.0f;
+        input[i] = sinf(2.0f * (float)M_PI * 440.0f * t) +
+                   0.25f * sinf(2.0f * (float)M_PI * 1330.0f * t);
+    }
+
+    /* Per-stage timings, one frame per sample. */
+    for (size_t i = 0; i < BENCH_SAMPLES + BENCH_WARMUP; i++) {
+        const float *src = input + i * hop;
+        uint64_t t0 = now_ns();
+        stft_gather_window(src, config->winvals, config->input, config->win,
+                           config->fftsize);
+        uint64_t t1 = now_ns();
+        pffft_transform_ordered(config->setup, config->input, config->output,
+                                config->work, PFFFT_FORWARD);
+        uint64_t t2 = now_ns();
+        stft_unpack_spectrum(config->output, row, config->fftsize);
+        uint64_t t3 = now_ns();
+
+        if (i >= BENCH_WARMUP) {
+            t_gather[i - BENCH_WARMUP] = t1 - t0;
+            t_fft[i - BENCH_WARMUP] = t2 - t1;
+            t_unpack[i - BENCH_WARMUP] = t3 - t2;
+        }
+    }
+
+    /* End-to-end frame timings through the public entry point. */
+    for (size_t i = 0; i < BENCH_SAMPLES + BENCH_WARMUP; i++) {
+        const float *src = input + i * hop;
+        uint64_t t0 = now_ns();
+        stft_gather_window(src, config->winvals, config->input, config->win,
+                           config->fftsize);
+        pffft_transform_ordered(config->setup, config->input, config->output,
+                                config->work, PFFFT_FORWARD);
+        stft_unpack_spectrum(config->output, row, config->fftsize);
+        uint64_t t1 = now_ns();
+        if (i >= BENCH_WARMUP)
+            t_frame[i - BENCH_WARMUP] = t1 - t0;
+    }
+
+    report(config, type, "gather_window", t_gather, BENCH_SAMPLES);
+    report(config, type, "fft", t_fft, BENCH_SAMPLES);
+    report(config, type, "unpack", t_unpack, BENCH_SAMPLES);
+    report(config, type, "frame", t_frame, BENCH_SAMPLES);
+
+    free(input);
+    free(row);
+    free(t_gather);
+    free(t_fft);
+    free(t_unpack);
+    free(t_frame);
+    stft_config_deinit(config);
+    return 0;
+}
+
+int main(void) {
+    const size_t wins[] = {256, 512, 1024};
+    const WinType types[] = {HANNING, HAMMING};
+
+    printf("# stft bench v1\n");
+    printf("win,fftsize,hop,wintype,stage,samples,median_ns,p99_ns,"
+           "frames_per_sec\n");
+
+    int rc = 0;
+    for (size_t w = 0; w < sizeof(wins) / sizeof(wins[0]); w++) {
+        size_t hops[] = {wins[w] / 4, wins[w] / 2};
+        for (size_t h = 0; h < sizeof(hops) / sizeof(hops[0]); h++) {
+            for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); t++) {
+                if (bench_shape(hops[h], wins[w], types[t]) != 0)
+                    rc = 1;
+            }
+        }
+    }
+    return rc;
+}
@@ -0,0 +1,197 @@
+/* Functional stand-in for pffft: correct results, no SIMD.  See pffft.h. */
+#include "pffft.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct PFFFT_Setup {
+    int N;
+    pffft_transform_t transform;
+};
+
+void *pffft_aligned_malloc(size_t nb_bytes) {
+    void *p = NULL;
+    size_t sz = (nb_bytes + 63) & ~(size_t)63;
+    if (sz == 0)
+        sz = 64;
+    if (posix_memalign(&p, 64, sz) != 0)
+        return NULL;
+    return p;
+}
+
+void pffft_aligned_free(void *p) { free(p); }
+
+int pffft_simd_size(void) { return 4; }
+
+static int is_pow2(int n) { return n > 0 && (n & (n - 1)) == 0; }
+
+PFFFT_Setup *pffft_new_setup(int N, pffft_transform_t transform) {
+    if (N < 2)
+        return NULL;
+    if (transform == PFFFT_REAL && (N & 1))
+        return NULL;
+    PFFFT_Setup *s = malloc(sizeof(*s));
+    if (!s)
+        return NULL;
+    s->N = N;
+    s->transform = transform;
+    return s;
+}
+
+void pffft_destroy_setup(PFFFT_Setup *s) { free(s); }
+
+/* In-place iterative radix-2 complex FFT; sign = -1 forward, +1 backward. */
+static void fft_pow2(double *re, double *im, int n, int sign) {
+    for (int i = 1, j = 0; i < n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j |= bit;
+        if (i < j) {
+            double t;
+            t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (int len = 2; len <= n; len <<= 1) {
+        double ang = sign * 2.0 * M_PI / len;
+        double wr = cos(ang), wi = sin(ang);
+        for (int i = 0; i < n; i += len) {
+            double cwr = 1.0, cwi = 0.0;
+            for (int k = 0; k < len / 2; k++) {
+                int a = i + k, b = i + k + len / 2;
+                double ur = re[a], ui = im[a];
+                double vr = re[b] * cwr - im[b] * cwi;
+                double vi = re[b] * cwi + im[b] * cwr;
+                re[a] = ur + vr;
+                im[a] = ui + vi;
+                re[b] = ur - vr;
+                im[b] = ui - vi;
+                double nwr = cwr * wr - cwi * wi;
+                cwi = cwr * wi + cwi * wr;
+                cwr = nwr;
+            }
+        }
+    }
+}
+
+/* Naive DFT for non-power-of-2 sizes (small N only in tests). */
+static void dft_naive(const double *re, const double *im, double *ore,
+                      double *oim, int n, int sign) {
+    for (int k = 0; k < n; k++) {
+        double sr = 0.0, si = 0.0;
+        for (int t = 0; t < n; t++) {
+            double ang = sign * 2.0 * M_PI * (double)k * (double)t / n;
+            double c = cos(ang), s = sin(ang);
+            sr += re[t] * c - im[t] * s;
+            si += re[t] * s + im[t] * c;
+        }
+        ore[k] = sr;
+        oim[k] = si;
+    }
+}
+
+/* Thread-safe like the real pffft: setups are read-only after creation,
+ * all scratch lives on the caller's stack/heap per invocation. */
+static void cfft(const PFFFT_Setup *s, double *re, double *im, int sign) {
+    if (is_pow2(s->N)) {
+        fft_pow2(re, im, s->N, sign);
+    } else {
+        double *tre = malloc(sizeof(double) * s->N);
+        double *tim = malloc(sizeof(double) * s->N);
+        dft_naive(re, im, tre, tim, s->N, sign);
+        memcpy(re, tre, sizeof(double) * s->N);
+        memcpy(im, tim, sizeof(double) * s->N);
+        free(tre);
+        free(tim);
+    }
+}
+
+/* The stub's "internal" layout is identical to the ordered layout, so
+ * pffft_transform and pffft_transform_ordered coincide and zreorder is a
+ * copy.  Real forward output packing matches pffft: out[0] = DC,
+ * out[1] = Nyquist, then interleaved re/im for bins 1..N/2-1.
+ * Backward is unnormalized (like pffft): inverse(forward(x)) == N * x. */
+void pffft_transform_ordered(PFFFT_Setup *s, const float *input, float *output,
+                             float *work, pffft_direction_t direction) {
+    (void)work;
+    int N = s->N;
+    double *cre = malloc(sizeof(double) * N);
+    double *cim = malloc(sizeof(double) * N);
+    if (s->transform == PFFFT_REAL) {
+        if (direction == PFFFT_FORWARD) {
+            for (int i = 0; i < N; i++) {
+                cre[i] = input[i];
+                cim[i] = 0.0;
+            }
+            cfft(s, cre, cim, -1);
+            output[0] = (float)cre[0];
+            output[1] = (float)cre[N / 2];
+            for (int k = 1; k < N / 2; k++) {
+                output[2 * k] = (float)cre[k];
+                output[2 * k + 1] = (float)cim[k];
+            }
+        } else {
+            cre[0] = input[0];
+            cim[0] = 0.0;
+            cre[N / 2] = input[1];
+            cim[N / 2] = 0.0;
+            for (int k = 1; k < N / 2; k++) {
+                cre[k] = input[2 * k];
+                cim[k] = input[2 * k + 1];
+                cre[N - k] = input[2 * k];
+                cim[N - k] = -input[2 * k + 1];
+            }
+            cfft(s, cre, cim, +1);
+            for (int i = 0; i < N; i++)
+                output[i] = (float)cre[i];
+        }
+    } else {
+        for (int i = 0; i < N; i++) {
+            cre[i] = input[2 * i];
+            cim[i] = input[2 * i + 1];
+        }
+        cfft(s, cre, cim, direction == PFFFT_FORWARD ? -1 : +1);
+        for (int i = 0; i < N; i++) {
+            output[2 * i] = (float)cre[i];
+            output[2 * i + 1] = (float)cim[i];
+        }
+    }
+    free(cre);
+    free(cim);
+}
+
+void pffft_transform(PFFFT_Setup *s, const float *input, float *output,
+                     float *work, pffft_direction_t direction) {
+    pffft_transform_ordered(s, input, output, work, direction);
+}
+
+void pffft_zreorder(PFFFT_Setup *s, const float *input, float *output,
+                    pffft_direction_t direction) {
+    (void)direction;
+    memcpy(output, input, sizeof(float) * s->N *
+                              (s->transform == PFFFT_COMPLEX ? 2 : 1));
+}
+
+void pffft_zconvolve_accumulate(PFFFT_Setup *s, const float *a, const float *b,
+                                float *ab, float scaling) {
+    int N = s->N;
+    if (s->transform == PFFFT_REAL) {
+        ab[0] += a[0] * b[0] * scaling;
+        ab[1] += a[1] * b[1] * scaling;
+        for (int k = 1; k < N / 2; k++) {
+            float ar = a[2 * k], ai = a[2 * k + 1];
+            float br = b[2 * k], bi = b[2 * k + 1];
+            ab[2 * k] += (ar * br - ai * bi) * scaling;
+            ab[2 * k + 1] += (ar * bi + ai * br) * scaling;
+        }
+    } else {
+        for (int k = 0; k < N; k++) {
+            float ar = a[2 * k], ai = a[2 * k + 1];
+            float br = b[2 * k], bi = b[2 * k + 1];
+            ab[2 * k] += (ar * br - ai * bi) * scaling;
+            ab[2 * k + 1] += (ar * bi + ai * br) * scaling;
+        }
+    }
+}
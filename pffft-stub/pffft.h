@@ -0,0 +1,41 @@
+/* Minimal local stand-in for the PFFFT public API, used only to build and
+ * run the test suite in a sandbox where the real pffft sources are not
+ * vendored.  Implements the same entry points with a plain radix-2 FFT
+ * (naive DFT for non-power-of-2 sizes).  NOT part of the library. */
+#ifndef PFFFT_H
+#define PFFFT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum { PFFFT_REAL, PFFFT_COMPLEX } pffft_transform_t;
+typedef enum { PFFFT_FORWARD, PFFFT_BACKWARD } pffft_direction_t;
+
+typedef struct PFFFT_Setup PFFFT_Setup;
+
+PFFFT_Setup *pffft_new_setup(int N, pffft_transform_t transform);
+void pffft_destroy_setup(PFFFT_Setup *setup);
+
+void pffft_transform(PFFFT_Setup *setup, const float *input, float *output,
+                     float *work, pffft_direction_t direction);
+void pffft_transform_ordered(PFFFT_Setup *setup, const float *input,
+                             float *output, float *work,
+                             pffft_direction_t direction);
+void pffft_zreorder(PFFFT_Setup *setup, const float *input, float *output,
+                    pffft_direction_t direction);
+void pffft_zconvolve_accumulate(PFFFT_Setup *setup, const float *dft_a,
+                                const float *dft_b, float *dft_ab,
+                                float scaling);
+
+void *pffft_aligned_malloc(size_t nb_bytes);
+void pffft_aligned_free(void *p);
+int pffft_simd_size(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PFFFT_H */
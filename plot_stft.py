@@ -4,19 +4,25 @@ import matplotlib.pyplot as plt
 # Parameters
 sample_rate = 8000.0
 duration = 1.0
-signal_len = int(sample_rate * duration)
-
-hop = 128
-win = 256
-fftsize = 256
-outsize = (signal_len - win) // hop + 1
 
 # Load signal
 time_data = np.loadtxt("signal.txt", comments="#")
 
-# Load STFT binary data
-data = np.fromfile("stft_out.bin", dtype=np.float32)
-data = data.reshape((outsize, fftsize // 2, 2))
+# Load STFT binary data: 64-byte header (see STFT_FileHeader_t in stft.h)
+# followed by nframes rows of `bins` interleaved complex float32 values.
+header_dtype = np.dtype([
+    ("magic", "<u4"), ("version", "<u4"), ("fftsize", "<u4"), ("hop", "<u4"),
+    ("win", "<u4"), ("wintype", "<u4"), ("bins", "<u4"), ("reserved0", "<u4"),
+    ("nframes", "<u8"), ("reserved", "u1", 24),
+])
+with open("stft_out.bin", "rb") as f:
+    header = np.frombuffer(f.read(header_dtype.itemsize), dtype=header_dtype)[0]
+    assert header["magic"] == 0x54465453, "not an STFT spectrogram file"
+    outsize = int(header["nframes"])
+    bins = int(header["bins"])
+    data = np.fromfile(f, dtype=np.float32)
+
+data = data.reshape((outsize, bins, 2))
 complex_data = data[..., 0] + 1j * data[..., 1]
 
 # Magnitude spectrogram
@@ -36,12 +36,19 @@
 #ifndef STFT_H_
 #define STFT_H_
 
+#include <fcntl.h>
 #include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-#define WTYPE float
 #include "window-bank.h"
 
 #ifndef CUSTOM_PFFFT_PATH
@@ -50,17 +57,25 @@
 #include CUSTOM_PFFFT_PATH
 #endif
 
-/** @brief Represents a complex number (packed as 2 floats) */
-typedef struct __attribute__((__packed__)) {
+/** @brief Represents a complex number (two adjacent floats) */
+typedef struct {
     float re; /**< Real part */
     float im; /**< Imaginary part */
 } Complex_t;
 
-_Static_assert(sizeof(Complex_t) == sizeof(float) * 2, "Complex_t not packed");
+_Static_assert(sizeof(Complex_t) == sizeof(float) * 2, "Complex_t not two floats");
+
+/** @brief Double-precision complex bin (see the stft_*_d family). */
+typedef struct __attribute__((__packed__)) {
+    double re; /**< Real part */
+    double im; /**< Imaginary part */
+} ComplexD_t;
+
+_Static_assert(sizeof(ComplexD_t) == sizeof(double) * 2,
+               "ComplexD_t not packed");
 
 #if defined(STFT_DEBUG)
 #include <assert.h>
-#include <stdio.h>
 #define STFT_ERR(...) fprintf(stderr, __VA_ARGS__)
 #else
 #define STFT_ERR(...)
@@ -68,27 +83,306 @@ _Static_assert(sizeof(Complex_t) == sizeof(float) * 2, "Complex_t not packed");
 
 /** @brief STFT computation mode */
 typedef enum sftft_mode {
-    STFT_SLIDING, /**< Placeholder for sliding window STFT (not implemented) */
-    STFT_FFT      /**< Simple windowed FFT mode */
+    STFT_SLIDING,  /**< Incremental sliding window STFT (see stft_push) */
+    STFT_FFT,      /**< Simple windowed FFT mode */
+    STFT_FFT_BATCH /**< Batched unordered FFTs + one final reorder pass */
 } STFT_Mode_t;
 
+#if defined(STFT_STATS)
+/**
+ * @brief Hot-path instrumentation counters (compile with -DSTFT_STATS).
+ *
+ * Accumulated inside the frame loops using rdtsc on x86 (a raw
+ * monotonic-clock read elsewhere), so "cycles" means TSC ticks on x86
+ * and nanoseconds on other targets. Without STFT_STATS the stats block,
+ * the accessors and every update site compile to nothing.
+ */
+typedef struct stft_stats {
+    uint64_t frames;         /**< Frames computed since last reset */
+    uint64_t cycles_gather;  /**< Cycles in gather + window multiply */
+    uint64_t cycles_fft;     /**< Cycles in the forward transform */
+    uint64_t cycles_unpack;  /**< Cycles in spectrum unpack/reorder */
+    uint64_t bytes_in;       /**< Input bytes consumed */
+    uint64_t bytes_out;      /**< Spectrum bytes produced */
+    uint64_t hwm_call_bytes; /**< Largest input bytes of a single call */
+} STFT_Stats_t;
+
+/** @brief Expand instrumentation code only when STFT_STATS is on. */
+#define STFT_STAT(expr) expr
+#else
+#define STFT_STAT(expr)
+#endif // STFT_STATS
+
+/** @brief Alignment of every buffer carved out of a config's arena. */
+#define STFT_ARENA_ALIGN 64
+
+/** @brief Round n up to the next STFT_ARENA_ALIGN boundary. */
+#define STFT_ARENA_ROUND(n)                                                    \
+    (((n) + (STFT_ARENA_ALIGN - 1)) & ~(size_t)(STFT_ARENA_ALIGN - 1))
+
 /**
  * @brief Configuration structure for STFT processing.
+ *
+ * The struct and all its per-config buffers live in one aligned arena
+ * (a single pffft_aligned_malloc); the struct sits at the base and
+ * winvals/input/work/output/history are carved out behind it, each on an
+ * STFT_ARENA_ALIGN boundary. `winvals` is placed directly before `input`
+ * so the windowing loop streams two adjacent arrays. Only the shared
+ * setup and window objects (see stft_setup_acquire) live outside.
+ */
+/** @brief Gather+window kernel signature (see stft_gather_window). */
+typedef void (*stft_gather_fn)(const float *src, const float *winvals,
+                               float *dst, size_t win, size_t fftsize);
+
+/** @brief Overlap-add kernel signature (see stft_overlap_add). */
+typedef void (*stft_ola_fn)(float *dst, const float *src,
+                            const float *winvals, size_t n);
+
+/** @brief Bulk magnitude kernel signature (see cabs_vec). */
+typedef void (*stft_mag_fn)(const Complex_t *src, float *dst, size_t n);
+
+/**
+ * @brief Hot-kernel function pointers, selected once per config.
+ *
+ * The baseline implementations use whatever ISA the build targets; on
+ * x86-64 GNU compilers, wider per-ISA variants (AVX2/FMA) are compiled
+ * alongside via function target attributes and picked at
+ * stft_config_init time from CPUID — one binary runs at full vector
+ * width on every fleet member without per-target rebuilds.
  */
+typedef struct stft_kernels {
+    stft_gather_fn gather_window; /**< Windowing + zero-pad */
+    stft_ola_fn overlap_add;      /**< ISTFT synthesis accumulate */
+    stft_mag_fn cabs;             /**< Bulk magnitude */
+} STFT_Kernels_t;
+
 typedef struct stft_config {
     size_t hop;         /**< Hop size between frames */
     size_t win;         /**< Window size */
     size_t insize;      /**< Total input signal size */
     size_t outsize;     /**< Number of frames = (insize - win) / hop + 1 */
     size_t fftsize;     /**< FFT size (next power of 2 ≥ win) */
-    PFFFT_Setup *setup; /**< Internal PFFFT setup object */
+    PFFFT_Setup *setup; /**< Shared PFFFT setup (cache-owned) */
+    float *winvals;     /**< Arena copy of the window, adjacent to input */
     float *input;       /**< Aligned input buffer for FFT */
     float *work;        /**< Aligned scratch buffer for FFT */
     float *output;      /**< Aligned FFT output buffer (interleaved) */
-    Window *pwin;       /**< Window coefficients */
+    Window *pwin;       /**< Shared window object (cache-owned) */
     STFT_Mode_t mode;   /**< Processing mode */
+    float *history;     /**< Sliding mode: last `win` input samples */
+    size_t nqbins;      /**< Registered sparse query bins (0 = none) */
+    size_t *qbins;      /**< Bin indices for stft_compute_sparse */
+    double *qcoef;      /**< Per-bin Goertzel constants (4 per bin) */
+    STFT_Kernels_t kern; /**< CPU-dispatched hot kernels */
+    size_t nbands;      /**< Filterbank bands (0 = no filterbank) */
+    size_t *fb_start;   /**< Per band: first contributing bin */
+    size_t *fb_len;     /**< Per band: contributing bin count */
+    size_t *fb_off;     /**< Per band: offset into fb_weights */
+    float *fb_weights;  /**< Concatenated triangular filter weights */
+#if defined(STFT_STATS)
+    STFT_Stats_t stats; /**< Instrumentation counters (STFT_STATS only) */
+#endif
 } STFT_Config_t;
 
+/**
+ * @brief Double-precision STFT configuration (see stft_config_init_d).
+ *
+ * Counterpart of STFT_Config_t for workloads where float accumulates
+ * visible error (very long windows, low-frequency bins). The window
+ * coefficients come from the same shared cache but are used at their
+ * native WTYPE (double) precision, and the transform runs a portable
+ * double-precision FFT: pffft has no double build vendored in this tree,
+ * so the kernel is a plain radix-2 pass over the `re`/`im` scratch pair
+ * (fftsize is always a power of two here). Both precisions link into one
+ * binary; nothing is compiled out.
+ *
+ * Same single-arena layout as STFT_Config_t: winvals/re/im are carved
+ * out of one aligned allocation behind the struct.
+ */
+typedef struct stft_config_d {
+    size_t hop;      /**< Hop size between frames */
+    size_t win;      /**< Window size */
+    size_t insize;   /**< Total input signal size */
+    size_t outsize;  /**< Number of frames = (insize - win) / hop + 1 */
+    size_t fftsize;  /**< FFT size (next power of 2 ≥ win) */
+    double *winvals; /**< Arena copy of the window at double precision */
+    double *re;      /**< FFT scratch, real parts */
+    double *im;      /**< FFT scratch, imaginary parts */
+    Window *pwin;    /**< Shared window object (cache-owned) */
+} STFT_ConfigD_t;
+
+/** @brief Magic bytes "STFT" identifying a spectrogram file. */
+#define STFT_FILE_MAGIC 0x54465453u
+
+/** @brief Current spectrogram file format version. */
+#define STFT_FILE_VERSION 1u
+
+/**
+ * @brief On-disk header of a streamed spectrogram file (64 bytes).
+ *
+ * Written as a placeholder on open and finalized (nframes) on close, so
+ * readers can mmap the file and seek frame i at
+ * sizeof(STFT_FileHeader_t) + i * bins * sizeof(Complex_t).
+ */
+typedef struct __attribute__((__packed__)) stft_file_header {
+    uint32_t magic;       /**< STFT_FILE_MAGIC */
+    uint32_t version;     /**< STFT_FILE_VERSION */
+    uint32_t fftsize;     /**< FFT size used */
+    uint32_t hop;         /**< Hop size between frames */
+    uint32_t win;         /**< Window size */
+    uint32_t wintype;     /**< WinType of the analysis window */
+    uint32_t bins;        /**< Complex bins stored per frame */
+    uint32_t reserved0;   /**< Zero; keeps nframes 8-byte aligned */
+    uint64_t nframes;     /**< Number of frames (finalized on close) */
+    uint8_t reserved[24]; /**< Zero; pads the header to 64 bytes */
+} STFT_FileHeader_t;
+
+_Static_assert(sizeof(STFT_FileHeader_t) == 64, "header not 64 bytes");
+
+/** @brief Output transform applied to each frame as it is computed. */
+typedef enum stft_output_kind {
+    STFT_OUT_COMPLEX,   /**< Interleaved complex bins (default layout) */
+    STFT_OUT_MAGNITUDE, /**< |X[k]| per bin */
+    STFT_OUT_POWER,     /**< |X[k]|^2 per bin */
+    STFT_OUT_DB         /**< 20 * log10(|X[k]| + eps) per bin */
+} STFT_Output_t;
+
+/** @brief Floor added before the log in STFT_OUT_DB to avoid -inf. */
+#define STFT_DB_EPS 1e-12f
+
+/**
+ * @brief Number of complex bins in one output frame: fftsize / 2 + 1.
+ *
+ * This is the real-spectrum output contract: every frame produced by the
+ * compute functions holds exactly STFT_BINS(fftsize) Complex_t values,
+ * with bin 0 = DC and bin fftsize / 2 = Nyquist, both with zero
+ * imaginary part (PFFFT's packed DC/Nyquist pair is unpacked on copy).
+ * Allocate output rows with this macro, never with fftsize.
+ */
+#define STFT_BINS(fftsize) ((fftsize) / 2 + 1)
+
+/**
+ * @brief Length-independent STFT compute plan.
+ *
+ * Carries everything that is expensive to build and independent of the
+ * input length: hop/win geometry, the PFFFT setup (twiddle tables), the
+ * filled window and the aligned scratch buffers. One plan serves inputs
+ * of any length via stft_execute, so per-utterance services stop paying
+ * pffft_new_setup + window_fill per request.
+ */
+typedef struct stft_plan {
+    size_t hop;         /**< Hop size between frames */
+    size_t win;         /**< Window size */
+    size_t fftsize;     /**< FFT size (next power of 2 ≥ win) */
+    PFFFT_Setup *setup; /**< Internal PFFFT setup object */
+    float *input;       /**< Aligned input buffer for FFT */
+    float *work;        /**< Aligned scratch buffer for FFT */
+    float *output;      /**< Aligned FFT output buffer (interleaved) */
+    Window *pwin;       /**< Window coefficients */
+} STFT_Plan_t;
+
+/** @brief Streaming spectrogram writer (see stft_writer_open). */
+typedef struct stft_writer {
+    FILE *fp;                 /**< Output stream */
+    STFT_FileHeader_t header; /**< Header being accumulated */
+} STFT_Writer_t;
+
+/** @brief Default submission queue depth for stft_async_init. */
+#define STFT_ASYNC_DEPTH 16
+
+/**
+ * @brief Per-frame completion callback for the async pipeline.
+ *
+ * Invoked on the worker thread as soon as frame `frame` has been
+ * unpacked into `bins` (STFT_BINS(fftsize) entries). The pointer stays
+ * valid — it is the caller's own output row — but the worker moves on
+ * immediately, so heavy consumers should copy or hand off quickly to
+ * keep the pipeline full.
+ */
+typedef void (*STFT_FrameDone_t)(size_t frame, const Complex_t *bins,
+                                 void *userdata);
+
+/** @brief One queued batch: signal range, output sink and notification. */
+typedef struct stft_async_job {
+    float *input;             /**< Signal to transform (insize samples) */
+    Complex_t **output;       /**< Caller-owned output rows */
+    STFT_FrameDone_t on_frame; /**< Optional per-frame callback */
+    void *userdata;           /**< Opaque pointer passed to on_frame */
+} STFT_AsyncJob_t;
+
+/**
+ * @brief Async STFT pipeline handle (see stft_async_init).
+ *
+ * One worker thread drains a bounded ring of submitted batches, so the
+ * capture thread returns from submission as soon as a slot is free and
+ * FFT work of frame i+1 overlaps downstream consumption of frame i.
+ * The handle borrows the config's scratch buffers: do not call
+ * stft_compute on the same config while the pipeline is live.
+ */
+typedef struct stft_async {
+    STFT_Config_t *config;    /**< Borrowed; caller retains ownership */
+    pthread_t worker;         /**< Single pipeline worker */
+    pthread_mutex_t mutex;    /**< Guards the ring and flags below */
+    pthread_cond_t not_empty; /**< Signalled on submit */
+    pthread_cond_t not_full;  /**< Signalled when a slot frees up */
+    pthread_cond_t drained;   /**< Signalled when all work completes */
+    STFT_AsyncJob_t *queue;   /**< Ring buffer of `depth` slots */
+    size_t depth;             /**< Ring capacity (backpressure bound) */
+    size_t head;              /**< Index of the oldest queued job */
+    size_t count;             /**< Jobs currently queued */
+    size_t inflight;          /**< Jobs dequeued but not yet finished */
+    bool stop;                /**< Worker shutdown flag */
+    int failed;               /**< Sticky error from any batch */
+} STFT_Async_t;
+
+/**
+ * @brief FIFO ring buffer front-end bridging capture chunks to hops.
+ *
+ * Capture callbacks push arbitrary-length chunks; frames are produced
+ * whenever `win` samples spanning the next hop boundary are available.
+ * The windowing stage reads straight out of the ring storage — when a
+ * frame does not wrap the end of the buffer there is no linearization
+ * copy at all, and a wrapping frame is windowed in two segments rather
+ * than staged through a temporary. See stft_ring_init.
+ */
+typedef struct stft_ring {
+    STFT_Config_t *config; /**< Borrowed; caller retains ownership */
+    float *data;           /**< Ring storage (capacity samples, aligned) */
+    size_t capacity;       /**< Storage size in samples */
+    size_t rpos;           /**< Start of the next frame within the ring */
+    size_t fill;           /**< Samples stored from rpos onwards */
+} STFT_Ring_t;
+
+/**
+ * @brief Entry in the process-wide PFFFT setup cache, keyed by fftsize.
+ *
+ * Setups are read-only after creation (pffft documents them as shareable
+ * across threads), so every config with the same fftsize can point at one
+ * copy of the twiddle tables. Reference-counted; destroyed when the last
+ * holder releases it.
+ */
+typedef struct stft_setup_entry {
+    size_t fftsize;                /**< FFT size this setup was built for */
+    int refs;                      /**< Number of live holders */
+    PFFFT_Setup *setup;            /**< Shared PFFFT setup */
+    struct stft_setup_entry *next; /**< Next entry in the cache list */
+} STFT_SetupEntry_t;
+
+/**
+ * @brief Entry in the process-wide window cache, keyed by (size, type).
+ *
+ * Windows are filled once on first acquisition and read-only afterwards,
+ * so all configs with the same geometry share one coefficient table
+ * instead of re-running the trig-heavy window_fill per stream.
+ */
+typedef struct stft_window_entry {
+    size_t size;                    /**< Window length */
+    WinType type;                   /**< Window function type */
+    int refs;                       /**< Number of live holders */
+    Window *pwin;                   /**< Shared, filled window */
+    struct stft_window_entry *next; /**< Next entry in the cache list */
+} STFT_WindowEntry_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -96,6 +390,35 @@ extern "C" {
 /** @brief Return the next power of two ≥ n. */
 unsigned long nextPow2(unsigned long n);
 
+/**
+ * @brief Pick the FFT size for a window of `win` samples.
+ *
+ * PFFFT real transforms accept any N = 2^a * 3^b * 5^c with 2^a >= 32,
+ * so sizes like 960 (= 2^6 * 3 * 5) run directly instead of being
+ * zero-padded to the next power of two. Returns `win` itself when it
+ * qualifies, otherwise falls back to nextPow2(win). The chosen size is
+ * exposed on the config as `fftsize`.
+ */
+size_t stft_fft_size(size_t win);
+
+/**
+ * @brief Gather one frame, apply the window and zero-pad in a single pass.
+ *
+ * Reads `win` samples from `src`, multiplies them by `winvals` and writes
+ * the products to `dst`, then zeroes dst[win..fftsize). Replaces the
+ * memset + memcpy + scalar-multiply triple so each frame touches the FFT
+ * input buffer once. Vectorized with SSE/NEON when available (compile-time
+ * dispatch, like PFFFT's own SIMD selection) with a scalar fallback.
+ *
+ * @param src Input samples (at least `win` readable floats, any alignment).
+ * @param winvals Window coefficients (at least `win` floats).
+ * @param dst Aligned FFT input buffer of `fftsize` floats.
+ * @param win Number of samples to gather.
+ * @param fftsize Total frame length (≥ win); the tail is zero-filled.
+ */
+void stft_gather_window(const float *src, const float *winvals, float *dst,
+                        size_t win, size_t fftsize);
+
 /** @brief Return the absolute value (magnitude) of a complex number. */
 float cabs(Complex_t a);
 
@@ -105,6 +428,91 @@ Complex_t csum(Complex_t a, Complex_t b);
 /** @brief Return the product of two complex numbers. */
 Complex_t cprod(Complex_t a, Complex_t b);
 
+/**
+ * @brief Magnitudes of a whole bin array in one pass.
+ *
+ * dst[k] = |src[k]| for k in [0, n). Vectorized with the same SIMD
+ * layers as the frame kernels; use this instead of a per-element cabs
+ * loop for magnitude scans over spectra.
+ *
+ * @param src Complex bins (interleaved re/im pairs).
+ * @param dst Output magnitudes (n floats).
+ * @param n Number of bins.
+ */
+void cabs_vec(const Complex_t *src, float *dst, size_t n);
+
+/**
+ * @brief Complex multiply-accumulate over buffers: acc[k] += a[k]*b[k].
+ *
+ * The workhorse of spectral filtering and cross-spectrum accumulation.
+ *
+ * @param acc Accumulator bins, updated in place.
+ * @param a First factor array.
+ * @param b Second factor array.
+ * @param n Number of bins.
+ */
+void cmac_vec(Complex_t *acc, const Complex_t *a, const Complex_t *b,
+              size_t n);
+
+/**
+ * @brief Find the strongest bin of a spectrum.
+ *
+ * Compares squared magnitudes (no per-bin sqrt); ties resolve to the
+ * lowest bin index.
+ *
+ * @param src Complex bins.
+ * @param n Number of bins (must be > 0).
+ * @param mag If non-NULL, receives the peak's magnitude (with sqrt).
+ * @return Index of the peak bin, or (size_t)-1 when n is 0 or src NULL.
+ */
+size_t cpeak_vec(const Complex_t *src, size_t n, float *mag);
+
+/**
+ * @brief Acquire a shared PFFFT real setup for the given FFT size.
+ *
+ * Consults the process-wide cache first; only the first acquisition of a
+ * given size pays pffft_new_setup. Thread-safe. Pair every call with
+ * stft_setup_release.
+ *
+ * @param fftsize FFT size (power of two).
+ * @return Shared setup, or NULL on failure.
+ */
+PFFFT_Setup *stft_setup_acquire(size_t fftsize);
+
+/**
+ * @brief Release a setup obtained from stft_setup_acquire.
+ *
+ * Drops one reference; the setup is destroyed when the count reaches
+ * zero. Setups not owned by the cache are destroyed directly.
+ *
+ * @param setup Setup to release (NULL is a no-op).
+ */
+void stft_setup_release(PFFFT_Setup *setup);
+
+/**
+ * @brief Acquire a shared, filled window of the given size and type.
+ *
+ * Consults the process-wide cache first; only the first acquisition of a
+ * given (size, type) pays window_init + window_fill. The returned window
+ * is shared and must be treated as read-only. Thread-safe. Pair every
+ * call with stft_window_release.
+ *
+ * @param size Window length.
+ * @param type Window function type.
+ * @return Shared filled window, or NULL on failure.
+ */
+Window *stft_window_acquire(size_t size, WinType type);
+
+/**
+ * @brief Release a window obtained from stft_window_acquire.
+ *
+ * Drops one reference; the window is freed when the count reaches zero.
+ * Windows not owned by the cache are freed directly.
+ *
+ * @param pwin Window to release (NULL is a no-op).
+ */
+void stft_window_release(Window *pwin);
+
 /**
  * @brief Initialize the STFT configuration.
  *
@@ -125,11 +533,82 @@ STFT_Config_t *stft_config_init(size_t hop, size_t win, size_t insize,
  */
 void stft_config_deinit(STFT_Config_t *config);
 
+/**
+ * @brief Unpack one PFFFT ordered real frame into spectrum bins.
+ *
+ * Expands the packed layout (bin 0 carries DC in .re and Nyquist in .im)
+ * into STFT_BINS(fftsize) Complex_t values: dst[0] = {DC, 0},
+ * dst[fftsize / 2] = {Nyquist, 0} and dst[k] for 0 < k < fftsize / 2 is
+ * copied as-is.
+ *
+ * @param packed Ordered real-FFT output (fftsize floats).
+ * @param dst Output array of STFT_BINS(fftsize) Complex_t.
+ * @param fftsize FFT size the frame was computed with.
+ */
+void stft_unpack_spectrum(const float *packed, Complex_t *dst,
+                          size_t fftsize);
+
+/**
+ * @brief Repack spectrum bins into PFFFT's ordered real layout.
+ *
+ * Inverse of stft_unpack_spectrum: reads STFT_BINS(fftsize) Complex_t
+ * values and writes fftsize floats with DC and Nyquist folded back into
+ * the first pair. The imaginary parts of bins 0 and fftsize / 2 are
+ * ignored (they are zero for any spectrum of a real signal).
+ *
+ * @param src Spectrum bins (STFT_BINS(fftsize) Complex_t).
+ * @param packed Output buffer of fftsize floats.
+ * @param fftsize FFT size for the backward transform.
+ */
+void stft_pack_spectrum(const Complex_t *src, float *packed, size_t fftsize);
+
+/**
+ * @brief FFT sizes that get a compile-time specialized frame loop.
+ *
+ * Each size N listed here expands (via token pasting) into a
+ * stft_compute_N variant whose windowing, transform and unpack sizes are
+ * all compile-time constants, so the optimizer can unroll the window
+ * multiply and fold the copy sizes. stft_compute dispatches to the
+ * matching variant automatically when win == fftsize == N; the generic
+ * loop remains the fallback for every other shape. Extend the list with
+ * one more X(N) to cover a new deployment size.
+ */
+#define STFT_SPECIALIZED_SIZES(X) X(512) X(1024)
+
+/**
+ * @brief Declare one specialized frame loop (see STFT_SPECIALIZED_SIZES).
+ *
+ * stft_compute_N computes the STFT_FFT frame loop with every size fixed
+ * to N at compile time. Requires config->win == config->fftsize == N;
+ * callers normally reach these through stft_compute's dispatch rather
+ * than directly.
+ */
+#define STFT_DECLARE_SPECIALIZED(N)                                            \
+    int stft_compute_##N(STFT_Config_t *config, float *input,                  \
+                         Complex_t **output);
+STFT_SPECIALIZED_SIZES(STFT_DECLARE_SPECIALIZED)
+#undef STFT_DECLARE_SPECIALIZED
+
 /**
  * @brief Compute STFT of the input signal.
  *
  * The output is written into a preallocated array of shape:
- * output[outsize][fftsize / 2], where each row contains complex frequency bins.
+ * output[outsize][STFT_BINS(fftsize)], where each row holds the unpacked
+ * real-spectrum bins (see STFT_BINS for the contract).
+ *
+ * When the frame shape matches one of STFT_SPECIALIZED_SIZES (and
+ * win == fftsize), the call is routed to the compile-time specialized
+ * variant; output is identical either way.
+ *
+ * In STFT_FFT_BATCH mode all frames are first run through PFFFT's
+ * unordered transform back-to-back (skipping the per-frame bit-reversal
+ * reorder and keeping the twiddle tables hot), then a single reorder pass
+ * brings every row into the ordered layout. The final contents of `output`
+ * are identical to STFT_FFT mode. Batch mode uses the output rows as
+ * transform scratch, which is fastest when each row is 16-byte aligned
+ * (rows from stft_output_alloc or pffft_aligned_malloc are); misaligned
+ * rows are staged through internal buffers at the cost of one extra copy
+ * per pass.
  *
  * @param config Initialized STFT configuration.
  * @param input Real input signal (length must be ≥ config->insize).
@@ -138,120 +617,2504 @@ void stft_config_deinit(STFT_Config_t *config);
  */
 int stft_compute(STFT_Config_t *config, float *input, Complex_t **output);
 
-#ifdef __cplusplus
-}
-#endif
+/**
+ * @brief Overlap-exploiting STFT for high-overlap configurations.
+ *
+ * When win is a multiple of hop, consecutive frames share all but one
+ * hop block of input. stft_compute re-reads each sample once per
+ * overlapping frame (win/hop times at 87.5% overlap); this variant
+ * sweeps the signal block by block instead, scattering each hop block —
+ * loaded from the signal exactly once — into the win/hop in-flight
+ * frame buffers it contributes to, then transforms frames as they
+ * complete. Signal memory traffic becomes O(1) loads per sample
+ * regardless of overlap factor; output is bit-identical to
+ * stft_compute. Falls back to stft_compute when win % hop != 0.
+ *
+ * @param config Initialized STFT configuration (STFT_FFT mode).
+ * @param input Real input signal (length must be ≥ config->insize).
+ * @param output 2D array of Complex_t to hold the results.
+ * @return 0 on success, -1 on error.
+ */
+int stft_compute_overlap(STFT_Config_t *config, float *input,
+                         Complex_t **output);
 
-/****************************/
-/*  Implementation Section  */
-/****************************/
+/**
+ * @brief Register the target bins for sparse (Goertzel) queries.
+ *
+ * Stores the bin set and precomputes per-bin Goertzel constants on the
+ * config; call once after stft_config_init, then use
+ * stft_compute_sparse. Replaces any previously registered set.
+ *
+ * @param config Initialized STFT configuration.
+ * @param bins Bin indices in [0, STFT_BINS(fftsize)).
+ * @param nbins Number of bins (must be > 0).
+ * @return 0 on success, -1 on error.
+ */
+int stft_register_bins(STFT_Config_t *config, const size_t *bins,
+                       size_t nbins);
 
-STFT_Config_t *stft_config_init(size_t hop, size_t win, size_t insize,
-                                WinType wintype, STFT_Mode_t mode) {
-    if (win > insize) {
-        STFT_ERR("input size too small.\n");
-        return NULL;
-    }
+/**
+ * @brief Evaluate only the registered bins per frame via Goertzel.
+ *
+ * Same hop/frame iteration and window tables as stft_compute, but each
+ * frame costs O(win) per registered bin instead of a full fftsize
+ * transform — for 8 bins of a 4096-point FFT that is orders of
+ * magnitude less arithmetic. Values match the corresponding bins of
+ * stft_compute output (the zero-padded tail contributes nothing to a
+ * pruned DFT, so padding is skipped entirely).
+ *
+ * @param config Initialized STFT configuration (STFT_FFT mode) with
+ *               bins registered via stft_register_bins.
+ * @param input Real input signal (length must be ≥ config->insize).
+ * @param output 2D array: output[i][j] receives registered bin j of
+ *               frame i (config->nqbins entries per row).
+ * @return 0 on success, -1 on error.
+ */
+int stft_compute_sparse(STFT_Config_t *config, float *input,
+                        Complex_t **output);
 
-    if (hop <= 0) {
-        STFT_ERR("invalid hop size.\n");
-        return NULL;
-    }
+/**
+ * @brief Attach a triangular filterbank with arbitrary band edges.
+ *
+ * Builds a sparse matrix of `nbands` triangular filters from
+ * `nbands + 2` band-edge frequencies in Hz (ascending): band b rises
+ * from edges[b] to a peak at edges[b+1] and falls to edges[b+2]. Only
+ * the nonzero weights and their bin span are stored per band, so
+ * applying the bank costs O(nonzeros), not O(nbands * bins). Replaces
+ * any previously attached bank.
+ *
+ * @param config Initialized STFT configuration.
+ * @param edges Band edges in Hz, nbands + 2 ascending values.
+ * @param nbands Number of bands (must be > 0).
+ * @param sample_rate Sample rate of the input signal in Hz.
+ * @return 0 on success, -1 on error.
+ */
+int stft_set_filterbank(STFT_Config_t *config, const float *edges,
+                        size_t nbands, float sample_rate);
 
-    size_t outsize = (insize - win) / hop + 1;
-    if (outsize <= 0) {
-        STFT_ERR("Invalid output size %zu.\n", outsize);
-        return NULL;
-    }
+/**
+ * @brief Attach a mel-spaced triangular filterbank.
+ *
+ * Places nbands triangles with edges equally spaced on the mel scale
+ * between fmin and fmax — the standard front-end for ML feature
+ * pipelines — and delegates to stft_set_filterbank.
+ *
+ * @param config Initialized STFT configuration.
+ * @param nbands Number of mel bands (e.g. 80).
+ * @param sample_rate Sample rate of the input signal in Hz.
+ * @param fmin Lowest band edge in Hz.
+ * @param fmax Highest band edge in Hz (≤ sample_rate / 2).
+ * @return 0 on success, -1 on error.
+ */
+int stft_set_mel_filterbank(STFT_Config_t *config, size_t nbands,
+                            float sample_rate, float fmin, float fmax);
 
-    STFT_Config_t *config = (STFT_Config_t *)malloc(sizeof(STFT_Config_t));
-    if (!config) {
-        STFT_ERR("Allocation failed for STFT_Config_t.\n");
-        return NULL;
-    }
+/**
+ * @brief Compute per-frame band energies with the filterbank fused in.
+ *
+ * Same frame loop as stft_compute, but right after the transform —
+ * while the packed spectrum is still hot in config->output — each
+ * band's triangular weights are applied to the power spectrum and only
+ * the band energies are emitted. A frame shrinks from
+ * STFT_BINS(fftsize) complex bins to nbands floats, so pipelines that
+ * reduce to mel bands anyway never materialize the full spectrogram.
+ *
+ * @param config Initialized STFT configuration (STFT_FFT mode) with a
+ *               filterbank attached.
+ * @param input Real input signal (length must be ≥ config->insize).
+ * @param output Row-major outsize x nbands band energies.
+ * @return 0 on success, -1 on error.
+ */
+int stft_compute_bands(STFT_Config_t *config, float *input, float *output);
 
-    size_t fftsize = nextPow2(win);
-    config->hop = hop;
-    config->win = win;
-    config->insize = insize;
-    config->outsize = outsize;
-    config->mode = mode;
-    config->fftsize = fftsize;
+/**
+ * @brief Validate a config's frame geometry and internal invariants.
+ *
+ * Checks everything the per-frame hot path relies on: buffers and
+ * setup present, hop nonzero, fftsize ≥ win, and — for batch modes —
+ * that the final frame's window span (outsize-1)*hop + win fits inside
+ * insize. Run once up front (stft_compute does this on every call);
+ * after it passes, stft_compute_frame_unsafe may be driven per frame
+ * with no validation at all.
+ *
+ * @param config Configuration to check.
+ * @return 0 when the config is sound, -1 otherwise.
+ */
+int stft_validate(const STFT_Config_t *config);
 
-    config->pwin = window_init(fftsize, wintype);
-    if (!config->pwin) {
-        STFT_ERR("Failed to allocate the window.\n");
-        goto cleanup;
-    }
+/**
+ * @brief Transform one frame with zero per-frame validation.
+ *
+ * The unchecked tier of the two-tier API: no NULL checks, no geometry
+ * checks, no mode dispatch — gather, transform, unpack, nothing else.
+ * For callers running their own frame schedulers at very high call
+ * rates, after validating the config once with stft_validate. `src`
+ * must point at least `win` readable samples (frame i of a batch is
+ * `input + i * hop`) and `out` must hold STFT_BINS(fftsize) bins.
+ *
+ * @param config Validated STFT configuration.
+ * @param src First sample of the frame.
+ * @param out Output row of STFT_BINS(fftsize) Complex_t.
+ */
+void stft_compute_frame_unsafe(STFT_Config_t *config, const float *src,
+                               Complex_t *out);
 
-    config->input = (float *)pffft_aligned_malloc(sizeof(float) * fftsize);
-    config->work = (float *)pffft_aligned_malloc(sizeof(float) * fftsize);
-    config->output = (float *)pffft_aligned_malloc(sizeof(float) * fftsize);
-    if (!config->input || !config->work || !config->output) {
-        STFT_ERR("Failed to allocate FFT buffers.\n");
-        goto cleanup;
-    }
+/**
+ * @brief Row stride (in Complex_t elements) of the flat output layout.
+ *
+ * The per-frame bin count STFT_BINS(fftsize), rounded up to a multiple of
+ * the PFFFT SIMD width so every row starts on an aligned boundary.
+ *
+ * @param config Initialized STFT configuration.
+ * @return Stride in Complex_t elements, or 0 on error.
+ */
+size_t stft_row_stride(const STFT_Config_t *config);
 
-    config->setup = pffft_new_setup(fftsize, PFFFT_REAL);
-    if (!config->setup) {
-        STFT_ERR("Failed to initialize PFFFT setup.\n");
-        goto cleanup;
-    }
+/**
+ * @brief Allocate one contiguous, aligned block for a flat spectrogram.
+ *
+ * Grabs outsize * stft_row_stride() Complex_t in a single
+ * pffft_aligned_malloc. Free with pffft_aligned_free.
+ *
+ * @param config Initialized STFT configuration.
+ * @return Pointer to the block, or NULL on failure.
+ */
+Complex_t *stft_output_alloc(const STFT_Config_t *config);
 
-    return config;
+/**
+ * @brief Compute the STFT into a single contiguous output block.
+ *
+ * Same computation as stft_compute, but frame i is written at
+ * output + i * stft_row_stride(config) instead of through a per-row
+ * pointer table, so the whole spectrogram lives in one allocation and
+ * scans stream linearly through memory. Honors STFT_FFT and
+ * STFT_FFT_BATCH modes.
+ *
+ * @param config Initialized STFT configuration.
+ * @param input Real input signal (length must be ≥ config->insize).
+ * @param output Contiguous block of outsize * stft_row_stride() Complex_t.
+ * @return 0 on success, -1 on error.
+ */
+int stft_compute_flat(STFT_Config_t *config, float *input, Complex_t *output);
 
-cleanup:
-    stft_config_deinit(config);
-    return NULL;
-}
+/**
+ * @brief Multiply-accumulate one frame into the output (overlap-add).
+ *
+ * dst[k] += src[k] * winvals[k] for k in [0, n). Vectorized with the same
+ * SSE/NEON dispatch as stft_gather_window.
+ *
+ * @param dst Accumulator (any alignment).
+ * @param src Time-domain frame samples.
+ * @param winvals Synthesis window coefficients.
+ * @param n Number of samples to accumulate.
+ */
+void stft_overlap_add(float *dst, const float *src, const float *winvals,
+                      size_t n);
 
-void stft_config_deinit(STFT_Config_t *config) {
-    if (!config)
-        return;
-    if (config->setup)
-        pffft_destroy_setup(config->setup);
-    if (config->input)
-        pffft_aligned_free(config->input);
-    if (config->work)
-        pffft_aligned_free(config->work);
-    if (config->output)
-        pffft_aligned_free(config->output);
-    if (config->pwin)
-        window_deinit(config->pwin);
-    free(config);
+/**
+ * @brief Reconstruct the time-domain signal from STFT frames.
+ *
+ * Inverse of stft_compute on the same config: each row of `frames`
+ * (STFT_BINS(fftsize) unpacked complex bins, as produced by stft_compute
+ * or stft_push) is repacked, run through PFFFT_BACKWARD, multiplied by the synthesis
+ * window (same table as analysis) and overlap-added into `output`. The
+ * result is normalized per sample by the accumulated squared-window sum
+ * (COLA), so any hop/window combination that covers every sample
+ * reconstructs correctly. Shares the config's setup and aligned buffers,
+ * so forward and inverse cost one setup.
+ *
+ * @param config Initialized STFT configuration (STFT_FFT mode geometry).
+ * @param frames 2D array of outsize frames from the forward transform.
+ * @param output Output signal buffer of config->insize floats.
+ * @return 0 on success, -1 on error.
+ */
+int istft_compute(STFT_Config_t *config, Complex_t **frames, float *output);
+
+/**
+ * @brief Reduce one packed complex frame to real spectrum values.
+ *
+ * Reads the PFFFT ordered real layout (bin 0 holds DC in .re and Nyquist
+ * in .im) and writes STFT_BINS(fftsize) floats: dst[0] = |DC|,
+ * dst[fftsize / 2] = |Nyquist| and dst[k] in between is the reduction of
+ * X[k]. Vectorized for magnitude/power; dB runs scalar through log10f.
+ *
+ * @param packed Ordered real-FFT output (fftsize floats).
+ * @param dst Output array of STFT_BINS(fftsize) floats.
+ * @param fftsize FFT size the frame was computed with.
+ * @param kind Which real reduction to apply (not STFT_OUT_COMPLEX).
+ */
+void stft_spectrum_postprocess(const float *packed, float *dst,
+                               size_t fftsize, STFT_Output_t kind);
+
+/**
+ * @brief Compute a real spectrogram (magnitude/power/dB) in one pass.
+ *
+ * Runs the normal frame loop but applies the requested reduction while
+ * the freshly transformed frame is still in the config's output buffer,
+ * writing half-spectrum floats instead of complex rows: frame i occupies
+ * output[i * STFT_BINS(fftsize) .. (i + 1) * STFT_BINS(fftsize)). Halves
+ * output bytes and removes the separate post-pass over the spectrogram.
+ *
+ * @param config Initialized STFT configuration (STFT_FFT mode).
+ * @param input Real input signal (length must be ≥ config->insize).
+ * @param output Contiguous block of outsize * STFT_BINS(fftsize) floats.
+ * @param kind Real reduction to apply (STFT_OUT_COMPLEX is rejected;
+ *             use stft_compute for complex output).
+ * @return 0 on success, -1 on error.
+ */
+int stft_compute_spectra(STFT_Config_t *config, float *input, float *output,
+                         STFT_Output_t kind);
+
+/**
+ * @brief Build a reusable, length-independent compute plan.
+ *
+ * @param hop Hop size between frames.
+ * @param win Window size.
+ * @param wintype Type of window to apply (e.g., Hamming).
+ * @return Pointer to initialized plan, or NULL on failure.
+ */
+STFT_Plan_t *stft_plan_init(size_t hop, size_t win, WinType wintype);
+
+/**
+ * @brief Deallocate a compute plan and its buffers.
+ *
+ * @param plan Pointer to STFT plan.
+ */
+void stft_plan_deinit(STFT_Plan_t *plan);
+
+/**
+ * @brief Number of frames a plan produces for an input of `insize` samples.
+ *
+ * @param plan Initialized plan.
+ * @param insize Input length in samples.
+ * @return Frame count, or 0 if insize < win.
+ */
+size_t stft_plan_outsize(const STFT_Plan_t *plan, size_t insize);
+
+/**
+ * @brief Execute a plan on an input of arbitrary length.
+ *
+ * Cheap per-call path: outsize is derived on the fly and no tables or
+ * buffers are rebuilt. Output layout matches stft_compute (one row of
+ * STFT_BINS(fftsize) complex bins per frame, stft_plan_outsize(plan, insize)
+ * rows).
+ *
+ * @param plan Initialized plan.
+ * @param input Real input signal of `insize` samples.
+ * @param insize Input length in samples (must be ≥ plan->win).
+ * @param output 2D array of Complex_t to hold the results.
+ * @return 0 on success, -1 on error.
+ */
+int stft_execute(STFT_Plan_t *plan, float *input, size_t insize,
+                 Complex_t **output);
+
+/**
+ * @brief Open a streaming spectrogram sink for a config.
+ *
+ * Writes a placeholder header and then accepts frames one at a time via
+ * stft_writer_append, so the whole spectrogram never has to exist in
+ * memory and readers can start consuming while compute is running.
+ *
+ * @param path Output file path.
+ * @param config Initialized STFT configuration describing the frames.
+ * @return Writer handle, or NULL on failure.
+ */
+STFT_Writer_t *stft_writer_open(const char *path, const STFT_Config_t *config);
+
+/**
+ * @brief Append one spectral frame (STFT_BINS(fftsize) complex bins) to the sink.
+ *
+ * @param writer Open writer handle.
+ * @param frame Frame data, as produced by stft_compute / stft_push.
+ * @return 0 on success, -1 on error.
+ */
+int stft_writer_append(STFT_Writer_t *writer, const Complex_t *frame);
+
+/**
+ * @brief Finalize the header (frame count) and close the sink.
+ *
+ * @param writer Open writer handle; freed by this call.
+ * @return 0 on success, -1 on error.
+ */
+int stft_writer_close(STFT_Writer_t *writer);
+
+/**
+ * @brief Compute the STFT of a file-backed signal without loading it.
+ *
+ * Memory-maps a raw float32 PCM file read-only, advises the kernel that
+ * access is sequential (madvise readahead) and runs the normal frame loop
+ * straight over the mapping. The signal is never copied into RAM as a
+ * whole, so files larger than memory stream through at disk bandwidth.
+ * The file must hold at least config->insize float samples.
+ *
+ * @param config Initialized STFT configuration (STFT_FFT / STFT_FFT_BATCH).
+ * @param path Path to the raw float32 signal file.
+ * @param output 2D array of Complex_t to hold the results.
+ * @return 0 on success, -1 on error.
+ */
+int stft_compute_mmap(STFT_Config_t *config, const char *path,
+                      Complex_t **output);
+
+/**
+ * @brief Compute the STFT using several worker threads.
+ *
+ * Frames are independent, so workers pull frame indices from a shared
+ * counter in small chunks (work-stealing style: fast workers drain the
+ * tail instead of idling on a static split). The PFFFT setup and window
+ * table are read-only and shared; each worker gets its own aligned
+ * input/work/output scratch triple, so `config`'s own scratch buffers are
+ * not touched.
+ *
+ * @param config Initialized STFT configuration (STFT_FFT mode).
+ * @param input Real input signal (length must be ≥ config->insize).
+ * @param output 2D array of Complex_t to hold the results.
+ * @param nthreads Number of worker threads; 0 picks the number of online
+ *                 CPUs.
+ * @return 0 on success, -1 on error.
+ */
+int stft_compute_parallel(STFT_Config_t *config, float *input,
+                          Complex_t **output, size_t nthreads);
+
+/**
+ * @brief Start an async STFT pipeline on an existing config.
+ *
+ * Spawns one worker thread and a bounded submission ring of `depth`
+ * batches (0 picks STFT_ASYNC_DEPTH). Batches run in submission order;
+ * the worker reuses the config's scratch buffers, so the config must
+ * not be used for synchronous computes while the pipeline is live.
+ *
+ * @param config Initialized STFT configuration (STFT_FFT mode).
+ * @param depth Submission queue capacity; 0 for the default.
+ * @return Pipeline handle, or NULL on error.
+ */
+STFT_Async_t *stft_async_init(STFT_Config_t *config, size_t depth);
+
+/**
+ * @brief Queue one batch for async computation.
+ *
+ * Blocks only while the ring is full (backpressure), then returns as
+ * soon as the batch is queued; the worker fills `output` row by row and
+ * fires `on_frame` (if non-NULL) after each frame. `input` and `output`
+ * must stay valid until the batch completes (see stft_async_drain).
+ *
+ * @param as Pipeline handle.
+ * @param input Real input signal (length must be ≥ config->insize).
+ * @param output 2D array of Complex_t to hold the results.
+ * @param on_frame Optional per-frame completion callback.
+ * @param userdata Opaque pointer forwarded to the callback.
+ * @return 0 on success, -1 on error.
+ */
+int stft_async_submit(STFT_Async_t *as, float *input, Complex_t **output,
+                      STFT_FrameDone_t on_frame, void *userdata);
+
+/**
+ * @brief Block until every submitted batch has completed.
+ *
+ * @param as Pipeline handle.
+ * @return 0 if all batches succeeded, -1 if any failed.
+ */
+int stft_async_drain(STFT_Async_t *as);
+
+/**
+ * @brief Drain outstanding work, stop the worker and free the handle.
+ *
+ * The borrowed config is untouched and remains usable afterwards.
+ *
+ * @param as Pipeline handle (NULL is a no-op).
+ */
+void stft_async_deinit(STFT_Async_t *as);
+
+/**
+ * @brief Compute the STFT of many channels through one shared config.
+ *
+ * Processes the same frame index across all channels before advancing,
+ * so the window table and PFFFT twiddle tables stay cache-resident for
+ * the whole channel sweep instead of being re-walked per channel (the
+ * cost of running N separate channel-major stft_compute calls). Every
+ * channel shares the config's geometry and scratch buffers; results are
+ * identical to calling stft_compute once per channel.
+ *
+ * @param config Initialized STFT configuration (STFT_FFT mode).
+ * @param inputs Array of `nchannels` signal pointers, each ≥ insize
+ *               samples.
+ * @param nchannels Number of channels.
+ * @param outputs Per-channel output row arrays: outputs[c][i] receives
+ *                frame i of channel c (STFT_BINS(fftsize) bins).
+ * @return 0 on success, -1 on error.
+ */
+int stft_compute_multi(STFT_Config_t *config, float *const *inputs,
+                       size_t nchannels, Complex_t ***outputs);
+
+/**
+ * @brief Multichannel STFT over interleaved sample data.
+ *
+ * Same frame-major sweep as stft_compute_multi, but reads channel c
+ * sample n from `input[n * nchannels + c]` — the layout sensor-array
+ * capture hardware typically delivers — so no deinterleave pass or
+ * per-channel staging copy is needed.
+ *
+ * @param config Initialized STFT configuration (STFT_FFT mode).
+ * @param input Interleaved signal, insize * nchannels samples.
+ * @param nchannels Number of interleaved channels.
+ * @param outputs Per-channel output row arrays (see stft_compute_multi).
+ * @return 0 on success, -1 on error.
+ */
+int stft_compute_multi_interleaved(STFT_Config_t *config, const float *input,
+                                   size_t nchannels, Complex_t ***outputs);
+
+/**
+ * @brief Create a ring buffer front-end tied to a config.
+ *
+ * `capacity` is the ring size in samples; 0 picks a default large
+ * enough for several frames (and any capacity smaller than win + hop is
+ * raised to it, the minimum for forward progress). The config's
+ * geometry, window and FFT setup are borrowed; the ring only owns its
+ * sample storage.
+ *
+ * @param config Initialized STFT configuration (STFT_FFT mode).
+ * @param capacity Ring size in samples; 0 for the default.
+ * @return Ring handle, or NULL on error.
+ */
+STFT_Ring_t *stft_ring_init(STFT_Config_t *config, size_t capacity);
+
+/**
+ * @brief Append a chunk of samples to the ring.
+ *
+ * Chunks may be any length — capture blocks do not need to align with
+ * hop boundaries. Fails without writing anything when the chunk does
+ * not fit; pop pending frames (stft_ring_pop) to free space.
+ *
+ * @param ring Ring handle.
+ * @param samples Samples to append.
+ * @param count Number of samples.
+ * @return 0 on success, -1 on error or overflow.
+ */
+int stft_ring_push(STFT_Ring_t *ring, const float *samples, size_t count);
+
+/**
+ * @brief Number of complete frames currently available to pop.
+ *
+ * @param ring Ring handle.
+ * @return Frame count (0 when ring is NULL).
+ */
+size_t stft_ring_available(const STFT_Ring_t *ring);
+
+/**
+ * @brief Produce the next frame from the ring, if one is available.
+ *
+ * Windows `win` samples in place in the ring storage, transforms them
+ * and writes STFT_BINS(fftsize) bins into `frame` (same layout as one
+ * row of stft_compute output), then advances the read position by one
+ * hop.
+ *
+ * @param ring Ring handle.
+ * @param frame Output row of STFT_BINS(fftsize) Complex_t.
+ * @return 1 when a frame was produced, 0 when not enough samples are
+ *         buffered yet, -1 on error.
+ */
+int stft_ring_pop(STFT_Ring_t *ring, Complex_t *frame);
+
+/**
+ * @brief Free a ring front-end. The borrowed config is untouched.
+ *
+ * @param ring Ring handle (NULL is a no-op).
+ */
+void stft_ring_deinit(STFT_Ring_t *ring);
+
+/**
+ * @brief Push one hop of samples into a sliding-mode STFT and emit a frame.
+ *
+ * Only valid for configs created with STFT_SLIDING. The config keeps the
+ * last `win` input samples internally; each call shifts in `hop` new
+ * samples, windows the current `win`-sample view once and writes one
+ * spectral frame (same layout as one row of stft_compute output) into
+ * `frame`. The history starts zero-filled, so the first `win / hop` frames
+ * correspond to a zero-padded signal start.
+ *
+ * @param config Initialized STFT configuration (STFT_SLIDING mode).
+ * @param hop_samples Pointer to `hop` new input samples.
+ * @param frame Output buffer for one frame (STFT_BINS(fftsize) complex bins).
+ * @return 0 on success, -1 on error.
+ */
+int stft_push(STFT_Config_t *config, const float *hop_samples,
+              Complex_t *frame);
+
+/**
+ * @brief Reset the sliding-mode history to zero.
+ *
+ * @param config Initialized STFT configuration (STFT_SLIDING mode).
+ * @return 0 on success, -1 on error.
+ */
+int stft_reset(STFT_Config_t *config);
+
+/**
+ * @brief Initialize a double-precision STFT configuration.
+ *
+ * Mirrors stft_config_init's STFT_FFT mode; see STFT_ConfigD_t for how
+ * the double path differs from the float one.
+ *
+ * @param hop Hop size between frames.
+ * @param win Window size.
+ * @param insize Length of the input signal.
+ * @param wintype Type of window to apply (e.g., Hamming).
+ * @return Pointer to initialized config, or NULL on failure.
+ */
+STFT_ConfigD_t *stft_config_init_d(size_t hop, size_t win, size_t insize,
+                                   WinType wintype);
+
+/**
+ * @brief Deallocate a double-precision STFT configuration.
+ *
+ * @param config Pointer to double-precision configuration.
+ */
+void stft_config_deinit_d(STFT_ConfigD_t *config);
+
+/**
+ * @brief In-place double-precision complex FFT (radix-2, n a power of 2).
+ *
+ * Forward, unnormalized — matching the float path's transform scaling so
+ * spectra from both precisions are directly comparable.
+ *
+ * @param re Real parts (n doubles, overwritten).
+ * @param im Imaginary parts (n doubles, overwritten).
+ * @param n Transform size (power of two).
+ */
+void stft_fft_d(double *re, double *im, size_t n);
+
+/**
+ * @brief Compute a double-precision STFT of the input signal.
+ *
+ * Same frame geometry and output contract as stft_compute — rows of
+ * STFT_BINS(fftsize) bins with real-valued DC and Nyquist — but every
+ * stage (windowing, transform, output) runs in double.
+ *
+ * @param config Initialized double-precision configuration.
+ * @param input Real input signal (length must be ≥ config->insize).
+ * @param output 2D array of ComplexD_t to hold the results.
+ * @return 0 on success, -1 on error.
+ */
+int stft_compute_d(STFT_ConfigD_t *config, const double *input,
+                   ComplexD_t **output);
+
+#if defined(STFT_STATS)
+/**
+ * @brief Copy the config's instrumentation counters into `out`.
+ *
+ * Only available with -DSTFT_STATS. Not synchronized against concurrent
+ * compute calls on the same config; snapshot from the owning thread.
+ *
+ * @param config Initialized STFT configuration.
+ * @param out Destination for the counter snapshot.
+ * @return 0 on success, -1 on error.
+ */
+int stft_stats_snapshot(const STFT_Config_t *config, STFT_Stats_t *out);
+
+/**
+ * @brief Zero the config's instrumentation counters.
+ *
+ * @param config Initialized STFT configuration.
+ * @return 0 on success, -1 on error.
+ */
+int stft_stats_reset(STFT_Config_t *config);
+#endif // STFT_STATS
+
+#ifdef __cplusplus
+}
+#endif
+
+/****************************/
+/*  Implementation Section  */
+/****************************/
+
+#if defined(__SSE__) || defined(__x86_64__)
+#include <xmmintrin.h>
+#define STFT_KERNEL_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define STFT_KERNEL_NEON
+#endif
+
+#if defined(STFT_STATS)
+#include <time.h>
+
+/** @brief Cycle counter: rdtsc on x86, raw monotonic ns elsewhere. */
+static inline uint64_t stft_cycles(void) {
+#if defined(__x86_64__)
+    unsigned lo, hi;
+    __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+int stft_stats_snapshot(const STFT_Config_t *config, STFT_Stats_t *out) {
+    if (!config || !out) {
+        STFT_ERR("Null pointer passed to stft_stats_snapshot.\n");
+        return -1;
+    }
+    *out = config->stats;
+    return 0;
+}
+
+int stft_stats_reset(STFT_Config_t *config) {
+    if (!config) {
+        STFT_ERR("Null pointer passed to stft_stats_reset.\n");
+        return -1;
+    }
+    memset(&config->stats, 0, sizeof(config->stats));
+    return 0;
+}
+
+/** @brief Per-call frame/byte bookkeeping shared by the frame loops. */
+static inline void stft_stats_account(STFT_Config_t *config) {
+    uint64_t in_bytes =
+        (uint64_t)((config->outsize - 1) * config->hop + config->win) *
+        sizeof(float);
+    config->stats.frames += config->outsize;
+    config->stats.bytes_in += in_bytes;
+    config->stats.bytes_out += (uint64_t)config->outsize *
+                               STFT_BINS(config->fftsize) *
+                               sizeof(Complex_t);
+    if (in_bytes > config->stats.hwm_call_bytes)
+        config->stats.hwm_call_bytes = in_bytes;
+}
+#endif // STFT_STATS
+
+void stft_gather_window(const float *src, const float *winvals, float *dst,
+                        size_t win, size_t fftsize) {
+    size_t k = 0;
+
+#if defined(STFT_KERNEL_SSE)
+    for (; k + 4 <= win; k += 4) {
+        __m128 s = _mm_loadu_ps(src + k);
+        __m128 w = _mm_loadu_ps(winvals + k);
+        _mm_storeu_ps(dst + k, _mm_mul_ps(s, w));
+    }
+#elif defined(STFT_KERNEL_NEON)
+    for (; k + 4 <= win; k += 4) {
+        float32x4_t s = vld1q_f32(src + k);
+        float32x4_t w = vld1q_f32(winvals + k);
+        vst1q_f32(dst + k, vmulq_f32(s, w));
+    }
+#endif
+
+    for (; k < win; ++k) {
+        dst[k] = src[k] * winvals[k];
+    }
+
+    if (fftsize > win) {
+        memset(dst + win, 0, (fftsize - win) * sizeof(float));
+    }
+}
+
+/* Process-wide caches for PFFFT setups and filled windows. Guarded by
+ * one mutex; both lists are short (one entry per distinct size in use). */
+static pthread_mutex_t stft_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static STFT_SetupEntry_t *stft_setup_cache = NULL;
+static STFT_WindowEntry_t *stft_window_cache = NULL;
+
+PFFFT_Setup *stft_setup_acquire(size_t fftsize) {
+    PFFFT_Setup *setup = NULL;
+
+    pthread_mutex_lock(&stft_cache_mutex);
+    for (STFT_SetupEntry_t *e = stft_setup_cache; e; e = e->next) {
+        if (e->fftsize == fftsize) {
+            e->refs++;
+            setup = e->setup;
+            pthread_mutex_unlock(&stft_cache_mutex);
+            return setup;
+        }
+    }
+
+    setup = pffft_new_setup(fftsize, PFFFT_REAL);
+    if (setup) {
+        STFT_SetupEntry_t *e =
+            (STFT_SetupEntry_t *)malloc(sizeof(STFT_SetupEntry_t));
+        if (!e) {
+            pffft_destroy_setup(setup);
+            setup = NULL;
+        } else {
+            e->fftsize = fftsize;
+            e->refs = 1;
+            e->setup = setup;
+            e->next = stft_setup_cache;
+            stft_setup_cache = e;
+        }
+    }
+    pthread_mutex_unlock(&stft_cache_mutex);
+
+    if (!setup)
+        STFT_ERR("Failed to acquire PFFFT setup.\n");
+    return setup;
+}
+
+void stft_setup_release(PFFFT_Setup *setup) {
+    if (!setup)
+        return;
+
+    pthread_mutex_lock(&stft_cache_mutex);
+    STFT_SetupEntry_t **pp = &stft_setup_cache;
+    for (; *pp; pp = &(*pp)->next) {
+        STFT_SetupEntry_t *e = *pp;
+        if (e->setup == setup) {
+            if (--e->refs > 0) {
+                pthread_mutex_unlock(&stft_cache_mutex);
+                return;
+            }
+            *pp = e->next;
+            free(e);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&stft_cache_mutex);
+
+    pffft_destroy_setup(setup);
+}
+
+Window *stft_window_acquire(size_t size, WinType type) {
+    Window *pwin = NULL;
+
+    pthread_mutex_lock(&stft_cache_mutex);
+    for (STFT_WindowEntry_t *e = stft_window_cache; e; e = e->next) {
+        if (e->size == size && e->type == type) {
+            e->refs++;
+            pwin = e->pwin;
+            pthread_mutex_unlock(&stft_cache_mutex);
+            return pwin;
+        }
+    }
+
+    pwin = window_init(size, type);
+    if (pwin && window_fill(pwin) != 0) {
+        window_deinit(pwin);
+        pwin = NULL;
+    }
+    if (pwin) {
+        STFT_WindowEntry_t *e =
+            (STFT_WindowEntry_t *)malloc(sizeof(STFT_WindowEntry_t));
+        if (!e) {
+            window_deinit(pwin);
+            pwin = NULL;
+        } else {
+            e->size = size;
+            e->type = type;
+            e->refs = 1;
+            e->pwin = pwin;
+            e->next = stft_window_cache;
+            stft_window_cache = e;
+        }
+    }
+    pthread_mutex_unlock(&stft_cache_mutex);
+
+    if (!pwin)
+        STFT_ERR("Failed to acquire window.\n");
+    return pwin;
+}
+
+void stft_window_release(Window *pwin) {
+    if (!pwin)
+        return;
+
+    pthread_mutex_lock(&stft_cache_mutex);
+    STFT_WindowEntry_t **pp = &stft_window_cache;
+    for (; *pp; pp = &(*pp)->next) {
+        STFT_WindowEntry_t *e = *pp;
+        if (e->pwin == pwin) {
+            if (--e->refs > 0) {
+                pthread_mutex_unlock(&stft_cache_mutex);
+                return;
+            }
+            *pp = e->next;
+            free(e);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&stft_cache_mutex);
+
+    window_deinit(pwin);
+}
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define STFT_DISPATCH_X86
+#include <immintrin.h>
+
+/* Per-ISA kernel variants. Target attributes let these compile with
+ * wider units enabled than the baseline build flags; they are only ever
+ * called after __builtin_cpu_supports confirms the host has them. */
+
+__attribute__((target("avx2"))) static void
+stft_gather_window_avx2(const float *src, const float *winvals, float *dst,
+                        size_t win, size_t fftsize) {
+    size_t k = 0;
+    for (; k + 8 <= win; k += 8) {
+        __m256 s = _mm256_loadu_ps(src + k);
+        __m256 w = _mm256_loadu_ps(winvals + k);
+        _mm256_storeu_ps(dst + k, _mm256_mul_ps(s, w));
+    }
+    for (; k < win; ++k) {
+        dst[k] = src[k] * winvals[k];
+    }
+    if (fftsize > win) {
+        memset(dst + win, 0, (fftsize - win) * sizeof(float));
+    }
+}
+
+__attribute__((target("avx2,fma"))) static void
+stft_overlap_add_avx2(float *dst, const float *src, const float *winvals,
+                      size_t n) {
+    size_t k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256 d = _mm256_loadu_ps(dst + k);
+        __m256 s = _mm256_loadu_ps(src + k);
+        __m256 w = _mm256_loadu_ps(winvals + k);
+        _mm256_storeu_ps(dst + k, _mm256_fmadd_ps(s, w, d));
+    }
+    for (; k < n; ++k) {
+        dst[k] += src[k] * winvals[k];
+    }
+}
+
+__attribute__((target("avx2"))) static void
+cabs_vec_avx2(const Complex_t *src, float *dst, size_t n) {
+    const float *p = (const float *)src;
+    size_t k = 0;
+    for (; k + 8 <= n; k += 8) {
+        __m256 v0 = _mm256_loadu_ps(p + 2 * k);
+        __m256 v1 = _mm256_loadu_ps(p + 2 * k + 8);
+        /* Lane-local deinterleave, then a 64-bit permute to restore
+         * ascending bin order across the two 128-bit lanes. */
+        __m256 re = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 im = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        re = _mm256_castpd_ps(
+            _mm256_permute4x64_pd(_mm256_castps_pd(re), 0xD8));
+        im = _mm256_castpd_ps(
+            _mm256_permute4x64_pd(_mm256_castps_pd(im), 0xD8));
+        __m256 pw =
+            _mm256_add_ps(_mm256_mul_ps(re, re), _mm256_mul_ps(im, im));
+        _mm256_storeu_ps(dst + k, _mm256_sqrt_ps(pw));
+    }
+    for (; k < n; ++k) {
+        dst[k] = sqrtf(p[2 * k] * p[2 * k] + p[2 * k + 1] * p[2 * k + 1]);
+    }
+}
+#endif /* STFT_DISPATCH_X86 */
+
+/** @brief Probe the host CPU once and fill the kernel table. */
+static void stft_kernels_select(STFT_Kernels_t *kern) {
+    kern->gather_window = stft_gather_window;
+    kern->overlap_add = stft_overlap_add;
+    kern->cabs = cabs_vec;
+
+#if defined(STFT_DISPATCH_X86)
+    if (__builtin_cpu_supports("avx2")) {
+        kern->gather_window = stft_gather_window_avx2;
+        kern->cabs = cabs_vec_avx2;
+        if (__builtin_cpu_supports("fma"))
+            kern->overlap_add = stft_overlap_add_avx2;
+    }
+#endif
+}
+
+STFT_Config_t *stft_config_init(size_t hop, size_t win, size_t insize,
+                                WinType wintype, STFT_Mode_t mode) {
+    if (mode != STFT_SLIDING && win > insize) {
+        STFT_ERR("input size too small.\n");
+        return NULL;
+    }
+
+    if (hop <= 0) {
+        STFT_ERR("invalid hop size.\n");
+        return NULL;
+    }
+
+    /* Sliding mode is length-independent: frames are produced per push. */
+    size_t outsize = (mode == STFT_SLIDING) ? 0 : (insize - win) / hop + 1;
+
+    size_t fftsize = stft_fft_size(win);
+
+    /* One arena holds the struct and every per-config buffer. Each region
+     * is rounded up to STFT_ARENA_ALIGN; winvals sits directly before
+     * input so the windowing loop streams two adjacent arrays. */
+    size_t head = STFT_ARENA_ROUND(sizeof(STFT_Config_t));
+    size_t fbytes = STFT_ARENA_ROUND(sizeof(float) * fftsize);
+    size_t hbytes =
+        (mode == STFT_SLIDING) ? STFT_ARENA_ROUND(sizeof(float) * win) : 0;
+    size_t total = head + 4 * fbytes + hbytes;
+
+    char *arena = (char *)pffft_aligned_malloc(total);
+    if (!arena) {
+        STFT_ERR("Allocation failed for STFT config arena.\n");
+        return NULL;
+    }
+
+    STFT_Config_t *config = (STFT_Config_t *)arena;
+    config->hop = hop;
+    config->win = win;
+    config->insize = insize;
+    config->outsize = outsize;
+    config->mode = mode;
+    config->fftsize = fftsize;
+    config->setup = NULL;
+    config->pwin = NULL;
+    config->winvals = (float *)(arena + head);
+    config->input = (float *)(arena + head + fbytes);
+    config->work = (float *)(arena + head + 2 * fbytes);
+    config->output = (float *)(arena + head + 3 * fbytes);
+    config->history =
+        (mode == STFT_SLIDING) ? (float *)(arena + head + 4 * fbytes) : NULL;
+    config->nqbins = 0;
+    config->qbins = NULL;
+    config->qcoef = NULL;
+    config->nbands = 0;
+    config->fb_start = NULL;
+    config->fb_len = NULL;
+    config->fb_off = NULL;
+    config->fb_weights = NULL;
+    stft_kernels_select(&config->kern);
+
+    config->pwin = stft_window_acquire(fftsize, wintype);
+    if (!config->pwin) {
+        goto cleanup;
+    }
+    memcpy(config->winvals, config->pwin->fvalues, sizeof(float) * fftsize);
+
+    if (mode == STFT_SLIDING) {
+        memset(config->history, 0, sizeof(float) * win);
+    }
+
+    config->setup = stft_setup_acquire(fftsize);
+    if (!config->setup) {
+        goto cleanup;
+    }
+
+    STFT_STAT(memset(&config->stats, 0, sizeof(config->stats)));
+
+    return config;
+
+cleanup:
+    stft_config_deinit(config);
+    return NULL;
+}
+
+void stft_config_deinit(STFT_Config_t *config) {
+    if (!config)
+        return;
+    if (config->setup)
+        stft_setup_release(config->setup);
+    if (config->pwin)
+        stft_window_release(config->pwin);
+    free(config->qbins);
+    free(config->qcoef);
+    free(config->fb_start);
+    free(config->fb_len);
+    free(config->fb_off);
+    free(config->fb_weights);
+    /* The struct is the arena base; one free releases every buffer. */
+    pffft_aligned_free(config);
+}
+
+void stft_unpack_spectrum(const float *packed, Complex_t *dst,
+                          size_t fftsize) {
+    size_t half = fftsize / 2;
+    dst[0].re = packed[0];
+    dst[0].im = 0.0f;
+    dst[half].re = packed[1];
+    dst[half].im = 0.0f;
+    memcpy(dst + 1, packed + 2, sizeof(float) * (fftsize - 2));
+}
+
+void stft_pack_spectrum(const Complex_t *src, float *packed, size_t fftsize) {
+    size_t half = fftsize / 2;
+    packed[0] = src[0].re;
+    packed[1] = src[half].re;
+    memcpy(packed + 2, src + 1, sizeof(float) * (fftsize - 2));
+}
+
+/* Generated specialized frame loops: every size below is a literal, so
+ * the helpers inline with constant trip counts and the optimizer can
+ * unroll the window multiply and fold the unpack copy sizes. */
+#define STFT_DEFINE_SPECIALIZED(N)                                             \
+    int stft_compute_##N(STFT_Config_t *config, float *input,                  \
+                         Complex_t **output) {                                 \
+        STFT_STAT(uint64_t st_t);                                              \
+        for (size_t i = 0; i < config->outsize; ++i) {                         \
+            STFT_STAT(st_t = stft_cycles());                                   \
+            config->kern.gather_window(input + i * config->hop,                \
+                                          config->winvals,             \
+                               config->input, (size_t)(N), (size_t)(N));       \
+            STFT_STAT(config->stats.cycles_gather += stft_cycles() - st_t);    \
+            STFT_STAT(st_t = stft_cycles());                                   \
+            pffft_transform_ordered(config->setup, config->input,              \
+                                    config->output, config->work,              \
+                                    PFFFT_FORWARD);                            \
+            STFT_STAT(config->stats.cycles_fft += stft_cycles() - st_t);       \
+            STFT_STAT(st_t = stft_cycles());                                   \
+            stft_unpack_spectrum(config->output, output[i], (size_t)(N));      \
+            STFT_STAT(config->stats.cycles_unpack += stft_cycles() - st_t);    \
+        }                                                                      \
+        STFT_STAT(stft_stats_account(config));                                 \
+        return 0;                                                              \
+    }
+STFT_SPECIALIZED_SIZES(STFT_DEFINE_SPECIALIZED)
+#undef STFT_DEFINE_SPECIALIZED
+
+int stft_validate(const STFT_Config_t *config) {
+    if (!config) {
+        STFT_ERR("Null config passed to stft_validate.\n");
+        return -1;
+    }
+
+    if (!config->setup || !config->winvals || !config->input ||
+        !config->work || !config->output) {
+        STFT_ERR("Config is missing buffers or FFT setup.\n");
+        return -1;
+    }
+
+    if (config->hop == 0 || config->win == 0 ||
+        config->fftsize < config->win) {
+        STFT_ERR("Inconsistent frame geometry (hop/win/fftsize).\n");
+        return -1;
+    }
+
+    if (config->mode == STFT_SLIDING)
+        return config->history ? 0 : -1;
+
+    /* The last frame's window span must fit inside the signal. */
+    if (config->outsize == 0 ||
+        (config->outsize - 1) * config->hop + config->win > config->insize) {
+        STFT_ERR("Frame count inconsistent with insize/hop/win.\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+void stft_compute_frame_unsafe(STFT_Config_t *config, const float *src,
+                               Complex_t *out) {
+    config->kern.gather_window(src, config->winvals, config->input,
+                               config->win, config->fftsize);
+
+    pffft_transform_ordered(config->setup, config->input, config->output,
+                            config->work, PFFFT_FORWARD);
+
+    stft_unpack_spectrum(config->output, out, config->fftsize);
+}
+
+int stft_compute(STFT_Config_t *config, float *input, Complex_t **output) {
+    if (!config || !input || !output) {
+        STFT_ERR("Null pointer passed to stft_compute.\n");
+        return -1;
+    }
+
+    /* Validate the whole batch geometry once; the frame loops below run
+     * unchecked. */
+    if (stft_validate(config) != 0)
+        return -1;
+
+#if defined(STFT_DEBUG)
+    assert(config->pwin && config->input && config->work && config->output &&
+           config->setup);
+#endif
+
+    /* Route full-window frames of a known size to the specialized loop. */
+    if (config->mode == STFT_FFT && config->win == config->fftsize) {
+        switch (config->fftsize) {
+#define STFT_DISPATCH_SPECIALIZED(N)                                           \
+    case N:                                                                    \
+        return stft_compute_##N(config, input, output);
+            STFT_SPECIALIZED_SIZES(STFT_DISPATCH_SPECIALIZED)
+#undef STFT_DISPATCH_SPECIALIZED
+        default:
+            break;
+        }
+    }
+
+    if (config->mode == STFT_FFT) {
+        STFT_STAT(uint64_t st_t);
+        for (size_t i = 0; i < config->outsize; ++i) {
+            STFT_STAT(st_t = stft_cycles());
+            config->kern.gather_window(input + i * config->hop, config->winvals,
+                               config->input, config->win, config->fftsize);
+            STFT_STAT(config->stats.cycles_gather += stft_cycles() - st_t);
+
+            STFT_STAT(st_t = stft_cycles());
+            pffft_transform_ordered(config->setup, config->input,
+                                    config->output, config->work,
+                                    PFFFT_FORWARD);
+            STFT_STAT(config->stats.cycles_fft += stft_cycles() - st_t);
+
+            STFT_STAT(st_t = stft_cycles());
+            stft_unpack_spectrum(config->output, output[i], config->fftsize);
+            STFT_STAT(config->stats.cycles_unpack += stft_cycles() - st_t);
+        }
+        STFT_STAT(stft_stats_account(config));
+        return 0;
+    }
+
+    if (config->mode == STFT_FFT_BATCH) {
+        STFT_STAT(uint64_t st_t);
+        /* Pass 1: unordered transforms straight into the caller's rows,
+         * no per-frame reorder and no intermediate output copy. PFFFT
+         * requires 16-byte aligned transform buffers; rows that are not
+         * (allowed by the stft_compute contract) are staged through the
+         * aligned config->output scratch instead. */
+        for (size_t i = 0; i < config->outsize; ++i) {
+            float *row = (float *)output[i];
+            STFT_STAT(st_t = stft_cycles());
+            config->kern.gather_window(input + i * config->hop, config->winvals,
+                               config->input, config->win, config->fftsize);
+            STFT_STAT(config->stats.cycles_gather += stft_cycles() - st_t);
+
+            STFT_STAT(st_t = stft_cycles());
+            if (((uintptr_t)row & 15) == 0) {
+                pffft_transform(config->setup, config->input, row,
+                                config->work, PFFFT_FORWARD);
+            } else {
+                pffft_transform(config->setup, config->input, config->output,
+                                config->work, PFFFT_FORWARD);
+                memcpy(row, config->output, sizeof(float) * config->fftsize);
+            }
+            STFT_STAT(config->stats.cycles_fft += stft_cycles() - st_t);
+        }
+
+        /* Pass 2: one streaming reorder sweep over the whole block.
+         * config->input is free again here and doubles as the aligned
+         * source for misaligned rows (zreorder is SIMD as well). */
+        STFT_STAT(st_t = stft_cycles());
+        for (size_t i = 0; i < config->outsize; ++i) {
+            float *row = (float *)output[i];
+            if (((uintptr_t)row & 15) != 0) {
+                memcpy(config->input, row, sizeof(float) * config->fftsize);
+                row = config->input;
+            }
+            pffft_zreorder(config->setup, row, config->output, PFFFT_FORWARD);
+            stft_unpack_spectrum(config->output, output[i], config->fftsize);
+        }
+        STFT_STAT(config->stats.cycles_unpack += stft_cycles() - st_t);
+        STFT_STAT(stft_stats_account(config));
+        return 0;
+    }
+
+    return -1;
+}
+
+int stft_compute_overlap(STFT_Config_t *config, float *input,
+                         Complex_t **output) {
+    if (!config || !input || !output) {
+        STFT_ERR("Null pointer passed to stft_compute_overlap.\n");
+        return -1;
+    }
+
+    if (config->mode != STFT_FFT) {
+        STFT_ERR("stft_compute_overlap requires STFT_FFT mode.\n");
+        return -1;
+    }
+
+    /* The block sweep needs frames to advance in whole hop blocks. */
+    if (config->win % config->hop != 0)
+        return stft_compute(config, input, output);
+
+    size_t hop = config->hop;
+    size_t fftsize = config->fftsize;
+    size_t R = config->win / hop; /* frames each hop block contributes to */
+
+    /* R in-flight frame assembly buffers, one aligned arena. */
+    size_t fbytes = STFT_ARENA_ROUND(sizeof(float) * fftsize);
+    char *arena = (char *)pffft_aligned_malloc(R * fbytes);
+    if (!arena) {
+        STFT_ERR("Allocation failed for overlap frame buffers.\n");
+        return -1;
+    }
+
+    STFT_STAT(uint64_t st_t);
+
+    /* Block b is input[b*hop .. b*hop+hop); it lands at window offset
+     * s*hop of frame b-s for each slot s. After block b, frame b-R+1
+     * has received all of its blocks and can be transformed. */
+    size_t nblocks = config->outsize + R - 1;
+    for (size_t b = 0; b < nblocks; ++b) {
+        const float *src = input + b * hop;
+
+        STFT_STAT(st_t = stft_cycles());
+        for (size_t s = 0; s < R; ++s) {
+            if (b < s || b - s >= config->outsize)
+                continue;
+            size_t i = b - s;
+            float *dst = (float *)(arena + (i % R) * fbytes) + s * hop;
+            config->kern.gather_window(src, config->winvals + s * hop, dst, hop,
+                               hop);
+        }
+        STFT_STAT(config->stats.cycles_gather += stft_cycles() - st_t);
+
+        if (b + 1 < R)
+            continue;
+        size_t i = b - R + 1;
+        float *frame = (float *)(arena + (i % R) * fbytes);
+        if (fftsize > config->win) {
+            memset(frame + config->win, 0,
+                   (fftsize - config->win) * sizeof(float));
+        }
+
+        STFT_STAT(st_t = stft_cycles());
+        pffft_transform_ordered(config->setup, frame, config->output,
+                                config->work, PFFFT_FORWARD);
+        STFT_STAT(config->stats.cycles_fft += stft_cycles() - st_t);
+
+        STFT_STAT(st_t = stft_cycles());
+        stft_unpack_spectrum(config->output, output[i], fftsize);
+        STFT_STAT(config->stats.cycles_unpack += stft_cycles() - st_t);
+    }
+
+    STFT_STAT(stft_stats_account(config));
+    pffft_aligned_free(arena);
+    return 0;
+}
+
+int stft_register_bins(STFT_Config_t *config, const size_t *bins,
+                       size_t nbins) {
+    if (!config || !bins || nbins == 0) {
+        STFT_ERR("Invalid arguments to stft_register_bins.\n");
+        return -1;
+    }
+
+    for (size_t j = 0; j < nbins; ++j) {
+        if (bins[j] >= STFT_BINS(config->fftsize)) {
+            STFT_ERR("Bin %zu out of range for fftsize %zu.\n", bins[j],
+                     config->fftsize);
+            return -1;
+        }
+    }
+
+    size_t *qbins = (size_t *)malloc(sizeof(size_t) * nbins);
+    double *qcoef = (double *)malloc(sizeof(double) * 4 * nbins);
+    if (!qbins || !qcoef) {
+        STFT_ERR("Allocation failed for sparse bin tables.\n");
+        free(qbins);
+        free(qcoef);
+        return -1;
+    }
+
+    /* Per bin: cos/sin of the bin frequency for the Goertzel recurrence
+     * plus the final rotation e^{-j(win-1)w} that aligns the result
+     * with the FFT's phase convention. */
+    for (size_t j = 0; j < nbins; ++j) {
+        double w = 2.0 * PI * (double)bins[j] / (double)config->fftsize;
+        double phase = w * (double)(config->win - 1);
+        qbins[j] = bins[j];
+        qcoef[4 * j + 0] = cos(w);
+        qcoef[4 * j + 1] = sin(w);
+        qcoef[4 * j + 2] = cos(phase);
+        qcoef[4 * j + 3] = sin(phase);
+    }
+
+    free(config->qbins);
+    free(config->qcoef);
+    config->qbins = qbins;
+    config->qcoef = qcoef;
+    config->nqbins = nbins;
+    return 0;
+}
+
+int stft_compute_sparse(STFT_Config_t *config, float *input,
+                        Complex_t **output) {
+    if (!config || !input || !output) {
+        STFT_ERR("Null pointer passed to stft_compute_sparse.\n");
+        return -1;
+    }
+
+    if (config->mode != STFT_FFT) {
+        STFT_ERR("stft_compute_sparse requires STFT_FFT mode.\n");
+        return -1;
+    }
+
+    if (config->nqbins == 0) {
+        STFT_ERR("No bins registered; call stft_register_bins first.\n");
+        return -1;
+    }
+
+    size_t win = config->win;
+
+    for (size_t i = 0; i < config->outsize; ++i) {
+        /* Window into the scratch buffer; the zero-pad tail is skipped —
+         * it adds nothing to a pruned DFT. */
+        config->kern.gather_window(input + i * config->hop, config->winvals,
+                           config->input, win, win);
+
+        for (size_t j = 0; j < config->nqbins; ++j) {
+            double c = config->qcoef[4 * j + 0];
+            double s = config->qcoef[4 * j + 1];
+            double coeff = 2.0 * c;
+
+            /* Goertzel recurrence over the windowed frame (double
+             * state: the error of the two-tap filter grows with win). */
+            double s1 = 0.0, s2 = 0.0;
+            for (size_t n = 0; n < win; ++n) {
+                double t = (double)config->input[n] + coeff * s1 - s2;
+                s2 = s1;
+                s1 = t;
+            }
+
+            /* X = e^{-j(win-1)w} * (s1 - e^{-jw} s2) */
+            double yre = s1 - s2 * c;
+            double yim = s2 * s;
+            double rre = config->qcoef[4 * j + 2];
+            double rim = config->qcoef[4 * j + 3];
+            output[i][j].re = (float)(yre * rre + yim * rim);
+            output[i][j].im = (float)(yim * rre - yre * rim);
+        }
+    }
+
+    return 0;
+}
+
+int stft_set_filterbank(STFT_Config_t *config, const float *edges,
+                        size_t nbands, float sample_rate) {
+    if (!config || !edges || nbands == 0 || sample_rate <= 0.0f) {
+        STFT_ERR("Invalid arguments to stft_set_filterbank.\n");
+        return -1;
+    }
+
+    for (size_t b = 0; b + 1 < nbands + 2; ++b) {
+        if (edges[b] >= edges[b + 1]) {
+            STFT_ERR("Band edges must be strictly ascending.\n");
+            return -1;
+        }
+    }
+
+    size_t bins = STFT_BINS(config->fftsize);
+    float hz_per_bin = sample_rate / (float)config->fftsize;
+
+    size_t *start = (size_t *)malloc(sizeof(size_t) * nbands);
+    size_t *len = (size_t *)malloc(sizeof(size_t) * nbands);
+    size_t *off = (size_t *)malloc(sizeof(size_t) * nbands);
+    /* Worst case every band touches every bin; shrunk after build. */
+    float *weights = (float *)malloc(sizeof(float) * nbands * bins);
+    if (!start || !len || !off || !weights) {
+        STFT_ERR("Allocation failed for filterbank tables.\n");
+        free(start);
+        free(len);
+        free(off);
+        free(weights);
+        return -1;
+    }
+
+    size_t total = 0;
+    for (size_t b = 0; b < nbands; ++b) {
+        float lo = edges[b], mid = edges[b + 1], hi = edges[b + 2];
+        size_t first = 0;
+        size_t count = 0;
+
+        for (size_t k = 0; k < bins; ++k) {
+            float f = (float)k * hz_per_bin;
+            float w = 0.0f;
+            if (f > lo && f < mid)
+                w = (f - lo) / (mid - lo);
+            else if (f >= mid && f < hi)
+                w = (hi - f) / (hi - mid);
+            if (w > 0.0f) {
+                if (count == 0)
+                    first = k;
+                weights[total + count] = w;
+                count++;
+            } else if (count > 0) {
+                break; /* triangles are contiguous in bin space */
+            }
+        }
+
+        start[b] = first;
+        len[b] = count;
+        off[b] = total;
+        total += count;
+    }
+
+    float *shrunk = (float *)realloc(weights, sizeof(float) * (total ? total : 1));
+    if (shrunk)
+        weights = shrunk;
+
+    free(config->fb_start);
+    free(config->fb_len);
+    free(config->fb_off);
+    free(config->fb_weights);
+    config->fb_start = start;
+    config->fb_len = len;
+    config->fb_off = off;
+    config->fb_weights = weights;
+    config->nbands = nbands;
+    return 0;
+}
+
+int stft_set_mel_filterbank(STFT_Config_t *config, size_t nbands,
+                            float sample_rate, float fmin, float fmax) {
+    if (!config || nbands == 0 || fmin < 0.0f || fmax <= fmin ||
+        fmax > sample_rate / 2.0f) {
+        STFT_ERR("Invalid arguments to stft_set_mel_filterbank.\n");
+        return -1;
+    }
+
+    float *edges = (float *)malloc(sizeof(float) * (nbands + 2));
+    if (!edges) {
+        STFT_ERR("Allocation failed for mel edge table.\n");
+        return -1;
+    }
+
+    /* Edges equally spaced on the mel scale between fmin and fmax. */
+    float mel_lo = 2595.0f * log10f(1.0f + fmin / 700.0f);
+    float mel_hi = 2595.0f * log10f(1.0f + fmax / 700.0f);
+    for (size_t b = 0; b < nbands + 2; ++b) {
+        float mel = mel_lo + (mel_hi - mel_lo) * (float)b / (float)(nbands + 1);
+        edges[b] = 700.0f * (powf(10.0f, mel / 2595.0f) - 1.0f);
+    }
+
+    int ret = stft_set_filterbank(config, edges, nbands, sample_rate);
+    free(edges);
+    return ret;
+}
+
+int stft_compute_bands(STFT_Config_t *config, float *input, float *output) {
+    if (!config || !input || !output) {
+        STFT_ERR("Null pointer passed to stft_compute_bands.\n");
+        return -1;
+    }
+
+    if (config->mode != STFT_FFT) {
+        STFT_ERR("stft_compute_bands requires STFT_FFT mode.\n");
+        return -1;
+    }
+
+    if (config->nbands == 0) {
+        STFT_ERR("No filterbank attached; call stft_set_filterbank first.\n");
+        return -1;
+    }
+
+    size_t half = config->fftsize / 2;
+
+    for (size_t i = 0; i < config->outsize; ++i) {
+        config->kern.gather_window(input + i * config->hop, config->winvals,
+                                   config->input, config->win,
+                                   config->fftsize);
+
+        pffft_transform_ordered(config->setup, config->input, config->output,
+                                config->work, PFFFT_FORWARD);
+
+        /* Reduce the packed spectrum to band energies while it is still
+         * hot in config->output; the full frame is never materialized. */
+        const float *packed = config->output;
+        float *row = output + i * config->nbands;
+        for (size_t b = 0; b < config->nbands; ++b) {
+            const float *w = config->fb_weights + config->fb_off[b];
+            size_t k0 = config->fb_start[b];
+            float sum = 0.0f;
+            for (size_t j = 0; j < config->fb_len[b]; ++j) {
+                size_t k = k0 + j;
+                float power;
+                if (k == 0)
+                    power = packed[0] * packed[0];
+                else if (k == half)
+                    power = packed[1] * packed[1];
+                else
+                    power = packed[2 * k] * packed[2 * k] +
+                            packed[2 * k + 1] * packed[2 * k + 1];
+                sum += w[j] * power;
+            }
+            row[b] = sum;
+        }
+    }
+
+    return 0;
+}
+
+size_t stft_row_stride(const STFT_Config_t *config) {
+    if (!config)
+        return 0;
+    size_t bins = STFT_BINS(config->fftsize);
+    size_t simd = (size_t)pffft_simd_size();
+    return (bins + simd - 1) / simd * simd;
+}
+
+Complex_t *stft_output_alloc(const STFT_Config_t *config) {
+    size_t stride = stft_row_stride(config);
+    if (stride == 0 || !config)
+        return NULL;
+    return (Complex_t *)pffft_aligned_malloc(sizeof(Complex_t) * stride *
+                                             config->outsize);
+}
+
+int stft_compute_flat(STFT_Config_t *config, float *input, Complex_t *output) {
+    if (!config || !input || !output) {
+        STFT_ERR("Null pointer passed to stft_compute_flat.\n");
+        return -1;
+    }
+
+#if defined(STFT_DEBUG)
+    assert(config->pwin && config->input && config->work && config->output &&
+           config->setup);
+#endif
+
+    if (config->mode != STFT_FFT && config->mode != STFT_FFT_BATCH) {
+        STFT_ERR("stft_compute_flat requires STFT_FFT or STFT_FFT_BATCH.\n");
+        return -1;
+    }
+
+    size_t stride = stft_row_stride(config);
+    bool batch = (config->mode == STFT_FFT_BATCH);
+
+    for (size_t i = 0; i < config->outsize; ++i) {
+        config->kern.gather_window(input + i * config->hop, config->winvals,
+                           config->input, config->win, config->fftsize);
+
+        float *row = (float *)(output + i * stride);
+        if (batch) {
+            /* Rows from stft_output_alloc are 16-byte aligned as PFFFT
+             * needs; caller-allocated blocks that are not get staged
+             * through the aligned scratch (same as stft_compute). */
+            if (((uintptr_t)row & 15) == 0) {
+                pffft_transform(config->setup, config->input, row,
+                                config->work, PFFFT_FORWARD);
+            } else {
+                pffft_transform(config->setup, config->input, config->output,
+                                config->work, PFFFT_FORWARD);
+                memcpy(row, config->output, sizeof(float) * config->fftsize);
+            }
+        } else {
+            pffft_transform_ordered(config->setup, config->input,
+                                    config->output, config->work,
+                                    PFFFT_FORWARD);
+            stft_unpack_spectrum(config->output, output + i * stride,
+                                 config->fftsize);
+        }
+    }
+
+    if (batch) {
+        for (size_t i = 0; i < config->outsize; ++i) {
+            float *row = (float *)(output + i * stride);
+            if (((uintptr_t)row & 15) != 0) {
+                memcpy(config->input, row, sizeof(float) * config->fftsize);
+                row = config->input;
+            }
+            pffft_zreorder(config->setup, row, config->output, PFFFT_FORWARD);
+            stft_unpack_spectrum(config->output, output + i * stride,
+                                 config->fftsize);
+        }
+    }
+
+    return 0;
+}
+
+void stft_overlap_add(float *dst, const float *src, const float *winvals,
+                      size_t n) {
+    size_t k = 0;
+
+#if defined(STFT_KERNEL_SSE)
+    for (; k + 4 <= n; k += 4) {
+        __m128 d = _mm_loadu_ps(dst + k);
+        __m128 s = _mm_loadu_ps(src + k);
+        __m128 w = _mm_loadu_ps(winvals + k);
+        _mm_storeu_ps(dst + k, _mm_add_ps(d, _mm_mul_ps(s, w)));
+    }
+#elif defined(STFT_KERNEL_NEON)
+    for (; k + 4 <= n; k += 4) {
+        float32x4_t d = vld1q_f32(dst + k);
+        float32x4_t s = vld1q_f32(src + k);
+        float32x4_t w = vld1q_f32(winvals + k);
+        vst1q_f32(dst + k, vmlaq_f32(d, s, w));
+    }
+#endif
+
+    for (; k < n; ++k) {
+        dst[k] += src[k] * winvals[k];
+    }
+}
+
+int istft_compute(STFT_Config_t *config, Complex_t **frames, float *output) {
+    if (!config || !frames || !output) {
+        STFT_ERR("Null pointer passed to istft_compute.\n");
+        return -1;
+    }
+
+#if defined(STFT_DEBUG)
+    assert(config->pwin && config->input && config->work && config->output &&
+           config->setup);
+#endif
+
+    size_t fftsize = config->fftsize;
+    size_t insize = config->insize;
+    const float *win = config->winvals;
+
+    /* Per-sample COLA normalization: accumulated squared synthesis
+     * window across all frames that touch each sample. */
+    float *norm = (float *)calloc(insize, sizeof(float));
+    if (!norm) {
+        STFT_ERR("Failed to allocate normalization buffer.\n");
+        return -1;
+    }
+
+    memset(output, 0, sizeof(float) * insize);
+
+    float scale = 1.0f / (float)fftsize; /* PFFFT backward is unnormalized */
+
+    for (size_t i = 0; i < config->outsize; ++i) {
+        /* Fold the unpacked DC/Nyquist bins back into PFFFT's layout. */
+        stft_pack_spectrum(frames[i], config->output, fftsize);
+        pffft_transform_ordered(config->setup, config->output, config->input,
+                                config->work, PFFFT_BACKWARD);
+
+        /* Only the first `win` samples carry signal; the fftsize tail was
+         * zero-padding in the forward pass and must not bias the COLA
+         * normalization. */
+        size_t start = i * config->hop;
+        size_t count = config->win;
+        if (start + count > insize)
+            count = insize - start;
+
+        /* Fold the 1/N scaling into the frame before overlap-add. */
+        for (size_t k = 0; k < count; ++k) {
+            config->input[k] *= scale;
+        }
+
+        config->kern.overlap_add(output + start, config->input, win, count);
+
+        for (size_t k = 0; k < count; ++k) {
+            norm[start + k] += win[k] * win[k];
+        }
+    }
+
+    for (size_t n = 0; n < insize; ++n) {
+        if (norm[n] > 1e-8f)
+            output[n] /= norm[n];
+    }
+
+    free(norm);
+    return 0;
+}
+
+void stft_spectrum_postprocess(const float *packed, float *dst,
+                               size_t fftsize, STFT_Output_t kind) {
+    size_t half = fftsize / 2;
+
+    /* Bin 0 packs DC in .re and Nyquist in .im; both get their own slot
+     * in the STFT_BINS(fftsize)-wide output. */
+    float dc = fabsf(packed[0]);
+    float nyq = fabsf(packed[1]);
+
+    if (kind == STFT_OUT_MAGNITUDE || kind == STFT_OUT_POWER) {
+        size_t k = 1;
+#if defined(STFT_KERNEL_SSE)
+        for (; k + 4 <= half; k += 4) {
+            __m128 v0 = _mm_loadu_ps(packed + 2 * k);
+            __m128 v1 = _mm_loadu_ps(packed + 2 * k + 4);
+            __m128 re = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 im = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+            __m128 p =
+                _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+            if (kind == STFT_OUT_MAGNITUDE)
+                p = _mm_sqrt_ps(p);
+            _mm_storeu_ps(dst + k, p);
+        }
+#endif
+        for (; k < half; ++k) {
+            float re = packed[2 * k];
+            float im = packed[2 * k + 1];
+            float p = re * re + im * im;
+            dst[k] = (kind == STFT_OUT_MAGNITUDE) ? sqrtf(p) : p;
+        }
+        dst[0] = (kind == STFT_OUT_MAGNITUDE) ? dc : dc * dc;
+        dst[half] = (kind == STFT_OUT_MAGNITUDE) ? nyq : nyq * nyq;
+        return;
+    }
+
+    /* dB path: scalar, log10f has no SIMD counterpart here. */
+    dst[0] = 20.0f * log10f(dc + STFT_DB_EPS);
+    for (size_t k = 1; k < half; ++k) {
+        float re = packed[2 * k];
+        float im = packed[2 * k + 1];
+        dst[k] = 20.0f * log10f(sqrtf(re * re + im * im) + STFT_DB_EPS);
+    }
+    dst[half] = 20.0f * log10f(nyq + STFT_DB_EPS);
+}
+
+int stft_compute_spectra(STFT_Config_t *config, float *input, float *output,
+                         STFT_Output_t kind) {
+    if (!config || !input || !output) {
+        STFT_ERR("Null pointer passed to stft_compute_spectra.\n");
+        return -1;
+    }
+
+    if (kind == STFT_OUT_COMPLEX) {
+        STFT_ERR("Use stft_compute for complex output.\n");
+        return -1;
+    }
+
+    if (config->mode != STFT_FFT) {
+        STFT_ERR("stft_compute_spectra requires STFT_FFT mode.\n");
+        return -1;
+    }
+
+    size_t bins = STFT_BINS(config->fftsize);
+    for (size_t i = 0; i < config->outsize; ++i) {
+        config->kern.gather_window(input + i * config->hop, config->winvals,
+                           config->input, config->win, config->fftsize);
+
+        pffft_transform_ordered(config->setup, config->input, config->output,
+                                config->work, PFFFT_FORWARD);
+
+        /* Reduce while the frame is still hot in config->output. */
+        stft_spectrum_postprocess(config->output, output + i * bins,
+                                  config->fftsize, kind);
+    }
+
+    return 0;
+}
+
+STFT_Plan_t *stft_plan_init(size_t hop, size_t win, WinType wintype) {
+    if (hop <= 0 || win <= 0) {
+        STFT_ERR("invalid plan geometry.\n");
+        return NULL;
+    }
+
+    STFT_Plan_t *plan = (STFT_Plan_t *)malloc(sizeof(STFT_Plan_t));
+    if (!plan) {
+        STFT_ERR("Allocation failed for STFT_Plan_t.\n");
+        return NULL;
+    }
+
+    size_t fftsize = stft_fft_size(win);
+    plan->hop = hop;
+    plan->win = win;
+    plan->fftsize = fftsize;
+    plan->setup = NULL;
+    plan->input = NULL;
+    plan->work = NULL;
+    plan->output = NULL;
+
+    plan->pwin = stft_window_acquire(fftsize, wintype);
+    if (!plan->pwin) {
+        goto cleanup;
+    }
+
+    plan->input = (float *)pffft_aligned_malloc(sizeof(float) * fftsize);
+    plan->work = (float *)pffft_aligned_malloc(sizeof(float) * fftsize);
+    plan->output = (float *)pffft_aligned_malloc(sizeof(float) * fftsize);
+    if (!plan->input || !plan->work || !plan->output) {
+        STFT_ERR("Failed to allocate FFT buffers.\n");
+        goto cleanup;
+    }
+
+    plan->setup = stft_setup_acquire(fftsize);
+    if (!plan->setup) {
+        goto cleanup;
+    }
+
+    return plan;
+
+cleanup:
+    stft_plan_deinit(plan);
+    return NULL;
+}
+
+void stft_plan_deinit(STFT_Plan_t *plan) {
+    if (!plan)
+        return;
+    if (plan->setup)
+        stft_setup_release(plan->setup);
+    if (plan->input)
+        pffft_aligned_free(plan->input);
+    if (plan->work)
+        pffft_aligned_free(plan->work);
+    if (plan->output)
+        pffft_aligned_free(plan->output);
+    if (plan->pwin)
+        stft_window_release(plan->pwin);
+    free(plan);
+}
+
+size_t stft_plan_outsize(const STFT_Plan_t *plan, size_t insize) {
+    if (!plan || insize < plan->win)
+        return 0;
+    return (insize - plan->win) / plan->hop + 1;
+}
+
+int stft_execute(STFT_Plan_t *plan, float *input, size_t insize,
+                 Complex_t **output) {
+    if (!plan || !input || !output) {
+        STFT_ERR("Null pointer passed to stft_execute.\n");
+        return -1;
+    }
+
+    size_t outsize = stft_plan_outsize(plan, insize);
+    if (outsize == 0) {
+        STFT_ERR("input size too small.\n");
+        return -1;
+    }
+
+#if defined(STFT_DEBUG)
+    assert(plan->pwin && plan->input && plan->work && plan->output &&
+           plan->setup);
+#endif
+
+    for (size_t i = 0; i < outsize; ++i) {
+        stft_gather_window(input + i * plan->hop, plan->pwin->fvalues,
+                           plan->input, plan->win, plan->fftsize);
+
+        pffft_transform_ordered(plan->setup, plan->input, plan->output,
+                                plan->work, PFFFT_FORWARD);
+
+        stft_unpack_spectrum(plan->output, output[i], plan->fftsize);
+    }
+
+    return 0;
+}
+
+STFT_Writer_t *stft_writer_open(const char *path,
+                                const STFT_Config_t *config) {
+    if (!path || !config) {
+        STFT_ERR("Null pointer passed to stft_writer_open.\n");
+        return NULL;
+    }
+
+    STFT_Writer_t *writer = (STFT_Writer_t *)malloc(sizeof(STFT_Writer_t));
+    if (!writer) {
+        STFT_ERR("Allocation failed for STFT_Writer_t.\n");
+        return NULL;
+    }
+
+    memset(&writer->header, 0, sizeof(writer->header));
+    writer->header.magic = STFT_FILE_MAGIC;
+    writer->header.version = STFT_FILE_VERSION;
+    writer->header.fftsize = (uint32_t)config->fftsize;
+    writer->header.hop = (uint32_t)config->hop;
+    writer->header.win = (uint32_t)config->win;
+    writer->header.wintype = (uint32_t)config->pwin->type;
+    writer->header.bins = (uint32_t)STFT_BINS(config->fftsize);
+    writer->header.nframes = 0;
+
+    writer->fp = fopen(path, "wb");
+    if (!writer->fp) {
+        STFT_ERR("Failed to open %s for writing.\n", path);
+        free(writer);
+        return NULL;
+    }
+
+    /* Placeholder header; nframes is finalized in stft_writer_close. */
+    if (fwrite(&writer->header, sizeof(writer->header), 1, writer->fp) != 1) {
+        STFT_ERR("Failed to write spectrogram header.\n");
+        fclose(writer->fp);
+        free(writer);
+        return NULL;
+    }
+
+    return writer;
+}
+
+int stft_writer_append(STFT_Writer_t *writer, const Complex_t *frame) {
+    if (!writer || !writer->fp || !frame) {
+        STFT_ERR("Null pointer passed to stft_writer_append.\n");
+        return -1;
+    }
+
+    if (fwrite(frame, sizeof(Complex_t), writer->header.bins, writer->fp) !=
+        writer->header.bins) {
+        STFT_ERR("Failed to append spectrogram frame.\n");
+        return -1;
+    }
+
+    writer->header.nframes++;
+    return 0;
+}
+
+int stft_writer_close(STFT_Writer_t *writer) {
+    if (!writer || !writer->fp) {
+        STFT_ERR("Null pointer passed to stft_writer_close.\n");
+        return -1;
+    }
+
+    int ret = 0;
+    if (fseek(writer->fp, 0, SEEK_SET) != 0 ||
+        fwrite(&writer->header, sizeof(writer->header), 1, writer->fp) != 1) {
+        STFT_ERR("Failed to finalize spectrogram header.\n");
+        ret = -1;
+    }
+
+    if (fclose(writer->fp) != 0)
+        ret = -1;
+    free(writer);
+    return ret;
+}
+
+int stft_compute_mmap(STFT_Config_t *config, const char *path,
+                      Complex_t **output) {
+    if (!config || !path || !output) {
+        STFT_ERR("Null pointer passed to stft_compute_mmap.\n");
+        return -1;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        STFT_ERR("Failed to open %s.\n", path);
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        (size_t)st.st_size < config->insize * sizeof(float)) {
+        STFT_ERR("File %s smaller than config->insize samples.\n", path);
+        close(fd);
+        return -1;
+    }
+
+    float *signal =
+        (float *)mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (signal == MAP_FAILED) {
+        STFT_ERR("Failed to mmap %s.\n", path);
+        return -1;
+    }
+
+    /* The frame loop walks strictly forward; tell the kernel so it can
+     * read ahead and drop pages behind us. */
+    madvise(signal, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    int ret = stft_compute(config, signal, output);
+
+    munmap(signal, (size_t)st.st_size);
+    return ret;
+}
+
+/** @brief Frames grabbed per counter increment by a parallel worker. */
+#define STFT_PARALLEL_CHUNK 8
+
+/** @brief Shared state for one stft_compute_parallel invocation. */
+typedef struct stft_parallel_job {
+    STFT_Config_t *config;  /**< Shared read-only configuration */
+    float *input;           /**< Shared input signal */
+    Complex_t **output;     /**< Shared output rows */
+    atomic_size_t next;     /**< Next unclaimed frame index */
+    atomic_int failed;      /**< Set when any worker fails */
+} STFT_ParallelJob_t;
+
+/** @brief Worker entry point: claim frame chunks until none are left. */
+void *stft_parallel_worker(void *arg) {
+    STFT_ParallelJob_t *job = (STFT_ParallelJob_t *)arg;
+    STFT_Config_t *config = job->config;
+    size_t fftsize = config->fftsize;
+
+    float *in = (float *)pffft_aligned_malloc(sizeof(float) * fftsize);
+    float *work = (float *)pffft_aligned_malloc(sizeof(float) * fftsize);
+    float *out = (float *)pffft_aligned_malloc(sizeof(float) * fftsize);
+    if (!in || !work || !out) {
+        STFT_ERR("Failed to allocate worker scratch buffers.\n");
+        atomic_store(&job->failed, 1);
+        goto done;
+    }
+
+    for (;;) {
+        size_t start =
+            atomic_fetch_add(&job->next, (size_t)STFT_PARALLEL_CHUNK);
+        if (start >= config->outsize)
+            break;
+        size_t end = start + STFT_PARALLEL_CHUNK;
+        if (end > config->outsize)
+            end = config->outsize;
+
+        for (size_t i = start; i < end; ++i) {
+            config->kern.gather_window(job->input + i * config->hop,
+                                       config->winvals, in, config->win,
+                                       fftsize);
+
+            pffft_transform_ordered(config->setup, in, out, work,
+                                    PFFFT_FORWARD);
+
+            stft_unpack_spectrum(out, job->output[i], fftsize);
+        }
+    }
+
+done:
+    if (in)
+        pffft_aligned_free(in);
+    if (work)
+        pffft_aligned_free(work);
+    if (out)
+        pffft_aligned_free(out);
+    return NULL;
+}
+
+int stft_compute_parallel(STFT_Config_t *config, float *input,
+                          Complex_t **output, size_t nthreads) {
+    if (!config || !input || !output) {
+        STFT_ERR("Null pointer passed to stft_compute_parallel.\n");
+        return -1;
+    }
+
+    if (config->mode != STFT_FFT) {
+        STFT_ERR("stft_compute_parallel requires STFT_FFT mode.\n");
+        return -1;
+    }
+
+    if (nthreads == 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = (n > 0) ? (size_t)n : 1;
+    }
+    if (nthreads > config->outsize)
+        nthreads = config->outsize;
+
+    STFT_ParallelJob_t job;
+    job.config = config;
+    job.input = input;
+    job.output = output;
+    atomic_init(&job.next, 0);
+    atomic_init(&job.failed, 0);
+
+    if (nthreads <= 1) {
+        stft_parallel_worker(&job);
+        return atomic_load(&job.failed) ? -1 : 0;
+    }
+
+    pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * nthreads);
+    if (!threads) {
+        STFT_ERR("Failed to allocate thread handles.\n");
+        return -1;
+    }
+
+    size_t spawned = 0;
+    for (size_t t = 0; t < nthreads; ++t) {
+        if (pthread_create(&threads[t], NULL, stft_parallel_worker, &job) !=
+            0) {
+            STFT_ERR("Failed to spawn worker thread %zu.\n", t);
+            break;
+        }
+        spawned++;
+    }
+
+    for (size_t t = 0; t < spawned; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+
+    if (spawned == 0)
+        return -1;
+    return atomic_load(&job.failed) ? -1 : 0;
 }
 
-int stft_compute(STFT_Config_t *config, float *input, Complex_t **output) {
-    if (!config || !input || !output) {
-        STFT_ERR("Null pointer passed to stft_compute.\n");
+/** @brief Run one queued batch on the worker, one frame at a time. */
+static int stft_async_run_job(STFT_Async_t *as, const STFT_AsyncJob_t *job) {
+    STFT_Config_t *config = as->config;
+
+    /* The config is borrowed and shared across batches; catch it going
+     * bad (caller tore it down or reshaped it mid-stream) here rather
+     * than crashing in the frame loop. */
+    if (stft_validate(config) != 0)
         return -1;
+
+    for (size_t i = 0; i < config->outsize; ++i) {
+        config->kern.gather_window(job->input + i * config->hop,
+                                   config->winvals,
+                           config->input, config->win, config->fftsize);
+
+        pffft_transform_ordered(config->setup, config->input, config->output,
+                                config->work, PFFFT_FORWARD);
+
+        stft_unpack_spectrum(config->output, job->output[i],
+                             config->fftsize);
+
+        if (job->on_frame)
+            job->on_frame(i, job->output[i], job->userdata);
     }
+    return 0;
+}
 
-#if defined(STFT_DEBUG)
-    assert(config->pwin && config->input && config->work && config->output &&
-           config->setup);
-#endif
+/** @brief Pipeline worker: dequeue batches until asked to stop. */
+void *stft_async_worker(void *arg) {
+    STFT_Async_t *as = (STFT_Async_t *)arg;
 
-    if (config->mode == STFT_FFT) {
-        for (size_t i = 0; i < config->outsize; ++i) {
-            memset(config->input, 0, sizeof(float) * config->fftsize);
-            memcpy(config->input, input + i * config->hop,
-                   config->win * sizeof(float));
+    pthread_mutex_lock(&as->mutex);
+    for (;;) {
+        while (as->count == 0 && !as->stop)
+            pthread_cond_wait(&as->not_empty, &as->mutex);
+        if (as->count == 0 && as->stop)
+            break;
 
-            for (size_t k = 0; k < config->fftsize; ++k) {
-                config->input[k] *= config->pwin->values[k];
-            }
+        STFT_AsyncJob_t job = as->queue[as->head];
+        as->head = (as->head + 1) % as->depth;
+        as->count--;
+        as->inflight++;
+        pthread_cond_signal(&as->not_full);
+        pthread_mutex_unlock(&as->mutex);
+
+        int rc = stft_async_run_job(as, &job);
+
+        pthread_mutex_lock(&as->mutex);
+        if (rc != 0)
+            as->failed = 1;
+        as->inflight--;
+        if (as->count == 0 && as->inflight == 0)
+            pthread_cond_broadcast(&as->drained);
+    }
+    pthread_mutex_unlock(&as->mutex);
+    return NULL;
+}
+
+STFT_Async_t *stft_async_init(STFT_Config_t *config, size_t depth) {
+    if (!config) {
+        STFT_ERR("Null config passed to stft_async_init.\n");
+        return NULL;
+    }
+
+    if (config->mode != STFT_FFT) {
+        STFT_ERR("stft_async_init requires STFT_FFT mode.\n");
+        return NULL;
+    }
+
+    if (depth == 0)
+        depth = STFT_ASYNC_DEPTH;
+
+    STFT_Async_t *as = (STFT_Async_t *)malloc(sizeof(STFT_Async_t));
+    if (!as) {
+        STFT_ERR("Allocation failed for STFT_Async_t.\n");
+        return NULL;
+    }
+
+    as->queue = (STFT_AsyncJob_t *)malloc(sizeof(STFT_AsyncJob_t) * depth);
+    if (!as->queue) {
+        STFT_ERR("Allocation failed for async job queue.\n");
+        free(as);
+        return NULL;
+    }
+
+    as->config = config;
+    as->depth = depth;
+    as->head = 0;
+    as->count = 0;
+    as->inflight = 0;
+    as->stop = false;
+    as->failed = 0;
+    pthread_mutex_init(&as->mutex, NULL);
+    pthread_cond_init(&as->not_empty, NULL);
+    pthread_cond_init(&as->not_full, NULL);
+    pthread_cond_init(&as->drained, NULL);
+
+    if (pthread_create(&as->worker, NULL, stft_async_worker, as) != 0) {
+        STFT_ERR("Failed to spawn async pipeline worker.\n");
+        pthread_mutex_destroy(&as->mutex);
+        pthread_cond_destroy(&as->not_empty);
+        pthread_cond_destroy(&as->not_full);
+        pthread_cond_destroy(&as->drained);
+        free(as->queue);
+        free(as);
+        return NULL;
+    }
+
+    return as;
+}
+
+int stft_async_submit(STFT_Async_t *as, float *input, Complex_t **output,
+                      STFT_FrameDone_t on_frame, void *userdata) {
+    if (!as || !input || !output) {
+        STFT_ERR("Null pointer passed to stft_async_submit.\n");
+        return -1;
+    }
+
+    pthread_mutex_lock(&as->mutex);
+    while (as->count == as->depth && !as->stop)
+        pthread_cond_wait(&as->not_full, &as->mutex);
+    if (as->stop) {
+        pthread_mutex_unlock(&as->mutex);
+        STFT_ERR("Submission on a stopped async pipeline.\n");
+        return -1;
+    }
+
+    size_t tail = (as->head + as->count) % as->depth;
+    as->queue[tail].input = input;
+    as->queue[tail].output = output;
+    as->queue[tail].on_frame = on_frame;
+    as->queue[tail].userdata = userdata;
+    as->count++;
+    pthread_cond_signal(&as->not_empty);
+    pthread_mutex_unlock(&as->mutex);
+    return 0;
+}
+
+int stft_async_drain(STFT_Async_t *as) {
+    if (!as) {
+        STFT_ERR("Null pointer passed to stft_async_drain.\n");
+        return -1;
+    }
+
+    pthread_mutex_lock(&as->mutex);
+    while (as->count > 0 || as->inflight > 0)
+        pthread_cond_wait(&as->drained, &as->mutex);
+    int failed = as->failed;
+    pthread_mutex_unlock(&as->mutex);
+    return failed ? -1 : 0;
+}
+
+void stft_async_deinit(STFT_Async_t *as) {
+    if (!as)
+        return;
+
+    pthread_mutex_lock(&as->mutex);
+    as->stop = true;
+    pthread_cond_broadcast(&as->not_empty);
+    pthread_cond_broadcast(&as->not_full);
+    pthread_mutex_unlock(&as->mutex);
+
+    pthread_join(as->worker, NULL);
+
+    pthread_mutex_destroy(&as->mutex);
+    pthread_cond_destroy(&as->not_empty);
+    pthread_cond_destroy(&as->not_full);
+    pthread_cond_destroy(&as->drained);
+    free(as->queue);
+    free(as);
+}
+
+/** @brief Strided variant of stft_gather_window for interleaved input. */
+static void stft_gather_window_strided(const float *src, size_t stride,
+                                       const float *winvals, float *dst,
+                                       size_t win, size_t fftsize) {
+    for (size_t k = 0; k < win; ++k) {
+        dst[k] = src[k * stride] * winvals[k];
+    }
+
+    if (fftsize > win) {
+        memset(dst + win, 0, (fftsize - win) * sizeof(float));
+    }
+}
+
+int stft_compute_multi(STFT_Config_t *config, float *const *inputs,
+                       size_t nchannels, Complex_t ***outputs) {
+    if (!config || !inputs || !outputs || nchannels == 0) {
+        STFT_ERR("Invalid arguments to stft_compute_multi.\n");
+        return -1;
+    }
+
+    if (config->mode != STFT_FFT) {
+        STFT_ERR("stft_compute_multi requires STFT_FFT mode.\n");
+        return -1;
+    }
+
+    /* Frame-major sweep: all channels of frame i before frame i+1, so
+     * winvals and the setup's twiddle tables stay hot across channels. */
+    for (size_t i = 0; i < config->outsize; ++i) {
+        size_t off = i * config->hop;
+        for (size_t c = 0; c < nchannels; ++c) {
+            config->kern.gather_window(inputs[c] + off, config->winvals,
+                               config->input, config->win, config->fftsize);
 
             pffft_transform_ordered(config->setup, config->input,
                                     config->output, config->work,
                                     PFFFT_FORWARD);
 
-            memcpy(output[i], config->output, sizeof(float) * config->fftsize);
+            stft_unpack_spectrum(config->output, outputs[c][i],
+                                 config->fftsize);
         }
+    }
+    return 0;
+}
+
+int stft_compute_multi_interleaved(STFT_Config_t *config, const float *input,
+                                   size_t nchannels, Complex_t ***outputs) {
+    if (!config || !input || !outputs || nchannels == 0) {
+        STFT_ERR("Invalid arguments to stft_compute_multi_interleaved.\n");
+        return -1;
+    }
+
+    if (config->mode != STFT_FFT) {
+        STFT_ERR("stft_compute_multi_interleaved requires STFT_FFT mode.\n");
+        return -1;
+    }
+
+    for (size_t i = 0; i < config->outsize; ++i) {
+        const float *frame = input + i * config->hop * nchannels;
+        for (size_t c = 0; c < nchannels; ++c) {
+            stft_gather_window_strided(frame + c, nchannels, config->winvals,
+                                       config->input, config->win,
+                                       config->fftsize);
+
+            pffft_transform_ordered(config->setup, config->input,
+                                    config->output, config->work,
+                                    PFFFT_FORWARD);
+
+            stft_unpack_spectrum(config->output, outputs[c][i],
+                                 config->fftsize);
+        }
+    }
+    return 0;
+}
+
+STFT_Ring_t *stft_ring_init(STFT_Config_t *config, size_t capacity) {
+    if (!config) {
+        STFT_ERR("Null config passed to stft_ring_init.\n");
+        return NULL;
+    }
+
+    if (config->mode != STFT_FFT) {
+        STFT_ERR("stft_ring_init requires STFT_FFT mode.\n");
+        return NULL;
+    }
+
+    if (capacity == 0)
+        capacity = 4 * config->win;
+    if (capacity < config->win + config->hop)
+        capacity = config->win + config->hop;
+
+    STFT_Ring_t *ring = (STFT_Ring_t *)malloc(sizeof(STFT_Ring_t));
+    if (!ring) {
+        STFT_ERR("Allocation failed for STFT_Ring_t.\n");
+        return NULL;
+    }
+
+    ring->data = (float *)pffft_aligned_malloc(sizeof(float) * capacity);
+    if (!ring->data) {
+        STFT_ERR("Allocation failed for ring storage.\n");
+        free(ring);
+        return NULL;
+    }
+
+    ring->config = config;
+    ring->capacity = capacity;
+    ring->rpos = 0;
+    ring->fill = 0;
+    return ring;
+}
+
+int stft_ring_push(STFT_Ring_t *ring, const float *samples, size_t count) {
+    if (!ring || !samples) {
+        STFT_ERR("Null pointer passed to stft_ring_push.\n");
+        return -1;
+    }
+
+    if (count > ring->capacity - ring->fill) {
+        STFT_ERR("Ring overflow: %zu samples pushed, %zu free.\n", count,
+                 ring->capacity - ring->fill);
+        return -1;
+    }
+
+    size_t wpos = (ring->rpos + ring->fill) % ring->capacity;
+    size_t tail = ring->capacity - wpos;
+    if (count <= tail) {
+        memcpy(ring->data + wpos, samples, count * sizeof(float));
+    } else {
+        memcpy(ring->data + wpos, samples, tail * sizeof(float));
+        memcpy(ring->data, samples + tail, (count - tail) * sizeof(float));
+    }
+    ring->fill += count;
+    return 0;
+}
+
+size_t stft_ring_available(const STFT_Ring_t *ring) {
+    if (!ring)
+        return 0;
+
+    size_t win = ring->config->win;
+    size_t hop = ring->config->hop;
+
+    /* Same gate as stft_ring_pop: a frame counts only once its full
+     * advance is buffered, or pop would refuse what we promised here. */
+    if (ring->fill < win || ring->fill < hop)
+        return 0;
+
+    size_t span = (win > hop) ? win : hop;
+    return (ring->fill - span) / hop + 1;
+}
+
+int stft_ring_pop(STFT_Ring_t *ring, Complex_t *frame) {
+    if (!ring || !frame) {
+        STFT_ERR("Null pointer passed to stft_ring_pop.\n");
+        return -1;
+    }
+
+    STFT_Config_t *config = ring->config;
+    size_t win = config->win;
+
+    /* For hop > win the advance consumes more than the frame itself, so
+     * wait until the full hop is buffered before committing to it. */
+    if (ring->fill < win || ring->fill < config->hop)
         return 0;
+
+    size_t tail = ring->capacity - ring->rpos;
+    if (win <= tail) {
+        /* Frame is contiguous: window straight out of the ring storage. */
+        config->kern.gather_window(ring->data + ring->rpos, config->winvals,
+                           config->input, win, config->fftsize);
+    } else {
+        /* Frame wraps: window each segment in place, no staging copy. */
+        config->kern.gather_window(ring->data + ring->rpos, config->winvals,
+                           config->input, tail, tail);
+        config->kern.gather_window(ring->data, config->winvals + tail,
+                           config->input + tail, win - tail,
+                           config->fftsize - tail);
     }
 
-    return -1;
+    pffft_transform_ordered(config->setup, config->input, config->output,
+                            config->work, PFFFT_FORWARD);
+
+    stft_unpack_spectrum(config->output, frame, config->fftsize);
+
+    ring->rpos = (ring->rpos + config->hop) % ring->capacity;
+    ring->fill -= config->hop;
+    return 1;
+}
+
+void stft_ring_deinit(STFT_Ring_t *ring) {
+    if (!ring)
+        return;
+    pffft_aligned_free(ring->data);
+    free(ring);
+}
+
+int stft_push(STFT_Config_t *config, const float *hop_samples,
+              Complex_t *frame) {
+    if (!config || !hop_samples || !frame) {
+        STFT_ERR("Null pointer passed to stft_push.\n");
+        return -1;
+    }
+
+    if (config->mode != STFT_SLIDING || !config->history) {
+        STFT_ERR("stft_push requires STFT_SLIDING mode.\n");
+        return -1;
+    }
+
+#if defined(STFT_DEBUG)
+    assert(config->pwin && config->input && config->work && config->output &&
+           config->setup);
+#endif
+
+    size_t hop = config->hop;
+    size_t win = config->win;
+
+    /* Shift in the new hop; for hop >= win only its last `win` samples
+     * survive. */
+    if (hop < win) {
+        memmove(config->history, config->history + hop,
+                (win - hop) * sizeof(float));
+        memcpy(config->history + (win - hop), hop_samples,
+               hop * sizeof(float));
+    } else {
+        memcpy(config->history, hop_samples + (hop - win),
+               win * sizeof(float));
+    }
+
+    /* Window the current view once and transform it. */
+    config->kern.gather_window(config->history, config->winvals,
+                               config->input,
+                       win, config->fftsize);
+
+    pffft_transform_ordered(config->setup, config->input, config->output,
+                            config->work, PFFFT_FORWARD);
+
+    stft_unpack_spectrum(config->output, frame, config->fftsize);
+    return 0;
+}
+
+int stft_reset(STFT_Config_t *config) {
+    if (!config || config->mode != STFT_SLIDING || !config->history) {
+        STFT_ERR("stft_reset requires STFT_SLIDING mode.\n");
+        return -1;
+    }
+    memset(config->history, 0, sizeof(float) * config->win);
+    return 0;
 }
 
 unsigned long nextPow2(unsigned long n) {
@@ -269,6 +3132,18 @@ unsigned long nextPow2(unsigned long n) {
     return n + 1;
 }
 
+size_t stft_fft_size(size_t win) {
+    size_t n = win;
+    while (n > 1 && n % 3 == 0)
+        n /= 3;
+    while (n > 1 && n % 5 == 0)
+        n /= 5;
+    /* What remains must be 2^a with a >= 5 (PFFFT real-transform rule). */
+    if (n >= 32 && (n & (n - 1)) == 0)
+        return win;
+    return (size_t)nextPow2((unsigned long)win);
+}
+
 float cabs(Complex_t a) { return sqrtf(a.re * a.re + a.im * a.im); }
 
 Complex_t csum(Complex_t a, Complex_t b) {
@@ -279,6 +3154,262 @@ Complex_t cprod(Complex_t a, Complex_t b) {
     return (Complex_t){a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
 }
 
+void cabs_vec(const Complex_t *src, float *dst, size_t n) {
+    const float *p = (const float *)src;
+    size_t k = 0;
+
+#if defined(STFT_KERNEL_SSE)
+    for (; k + 4 <= n; k += 4) {
+        __m128 v0 = _mm_loadu_ps(p + 2 * k);
+        __m128 v1 = _mm_loadu_ps(p + 2 * k + 4);
+        __m128 re = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 im = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 pw = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+        _mm_storeu_ps(dst + k, _mm_sqrt_ps(pw));
+    }
+#elif defined(STFT_KERNEL_NEON) && defined(__aarch64__)
+    /* vsqrtq_f32 is AArch64-only; ARMv7 NEON falls through to the
+     * scalar loop below. */
+    for (; k + 4 <= n; k += 4) {
+        float32x4x2_t v = vld2q_f32(p + 2 * k);
+        float32x4_t pw = vmlaq_f32(vmulq_f32(v.val[0], v.val[0]),
+                                   v.val[1], v.val[1]);
+        vst1q_f32(dst + k, vsqrtq_f32(pw));
+    }
+#endif
+
+    for (; k < n; ++k) {
+        dst[k] = sqrtf(p[2 * k] * p[2 * k] + p[2 * k + 1] * p[2 * k + 1]);
+    }
+}
+
+void cmac_vec(Complex_t *acc, const Complex_t *a, const Complex_t *b,
+              size_t n) {
+    float *pacc = (float *)acc;
+    const float *pa = (const float *)a;
+    const float *pb = (const float *)b;
+    size_t k = 0;
+
+#if defined(STFT_KERNEL_SSE)
+    /* Interleaved complex multiply: for each re/im pair,
+     * acc += (a.re*b.re - a.im*b.im, a.re*b.im + a.im*b.re). */
+    for (; k + 2 <= n; k += 2) {
+        __m128 va = _mm_loadu_ps(pa + 2 * k);
+        __m128 vb = _mm_loadu_ps(pb + 2 * k);
+        __m128 vacc = _mm_loadu_ps(pacc + 2 * k);
+        __m128 are = _mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 aim = _mm_shuffle_ps(va, va, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 bsw = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 3, 0, 1));
+        __m128 t0 = _mm_mul_ps(are, vb);  /* a.re*b.re, a.re*b.im */
+        __m128 t1 = _mm_mul_ps(aim, bsw); /* a.im*b.im, a.im*b.re */
+        /* Subtract in the re lanes, add in the im lanes. */
+        __m128 sign = _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f);
+        vacc = _mm_add_ps(vacc, _mm_add_ps(t0, _mm_mul_ps(t1, sign)));
+        _mm_storeu_ps(pacc + 2 * k, vacc);
+    }
+#elif defined(STFT_KERNEL_NEON)
+    for (; k + 4 <= n; k += 4) {
+        float32x4x2_t va = vld2q_f32(pa + 2 * k);
+        float32x4x2_t vb = vld2q_f32(pb + 2 * k);
+        float32x4x2_t vacc = vld2q_f32(pacc + 2 * k);
+        vacc.val[0] = vmlsq_f32(vmlaq_f32(vacc.val[0], va.val[0], vb.val[0]),
+                                va.val[1], vb.val[1]);
+        vacc.val[1] = vmlaq_f32(vmlaq_f32(vacc.val[1], va.val[0], vb.val[1]),
+                                va.val[1], vb.val[0]);
+        vst2q_f32(pacc + 2 * k, vacc);
+    }
+#endif
+
+    for (; k < n; ++k) {
+        float are = pa[2 * k], aim = pa[2 * k + 1];
+        float bre = pb[2 * k], bim = pb[2 * k + 1];
+        pacc[2 * k] += are * bre - aim * bim;
+        pacc[2 * k + 1] += are * bim + aim * bre;
+    }
+}
+
+size_t cpeak_vec(const Complex_t *src, size_t n, float *mag) {
+    if (!src || n == 0) {
+        STFT_ERR("Invalid arguments to cpeak_vec.\n");
+        return (size_t)-1;
+    }
+
+    const float *p = (const float *)src;
+    size_t best = 0;
+    float best_pw = p[0] * p[0] + p[1] * p[1];
+    size_t k = 1;
+
+#if defined(STFT_KERNEL_SSE)
+    for (; k + 4 <= n; k += 4) {
+        __m128 v0 = _mm_loadu_ps(p + 2 * k);
+        __m128 v1 = _mm_loadu_ps(p + 2 * k + 4);
+        __m128 re = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 im = _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 pw = _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im));
+
+        float lane[4];
+        _mm_storeu_ps(lane, pw);
+        for (size_t j = 0; j < 4; ++j) {
+            if (lane[j] > best_pw) {
+                best_pw = lane[j];
+                best = k + j;
+            }
+        }
+    }
+#endif
+
+    for (; k < n; ++k) {
+        float pw = p[2 * k] * p[2 * k] + p[2 * k + 1] * p[2 * k + 1];
+        if (pw > best_pw) {
+            best_pw = pw;
+            best = k;
+        }
+    }
+
+    if (mag)
+        *mag = sqrtf(best_pw);
+    return best;
+}
+
+STFT_ConfigD_t *stft_config_init_d(size_t hop, size_t win, size_t insize,
+                                   WinType wintype) {
+    if (win > insize) {
+        STFT_ERR("input size too small.\n");
+        return NULL;
+    }
+
+    if (hop <= 0) {
+        STFT_ERR("invalid hop size.\n");
+        return NULL;
+    }
+
+    size_t outsize = (insize - win) / hop + 1;
+    /* The double path runs a radix-2 FFT, so it stays on nextPow2 even
+     * though the float path accepts 2^a*3^b*5^c sizes directly. */
+    size_t fftsize = nextPow2(win);
+
+    size_t head = STFT_ARENA_ROUND(sizeof(STFT_ConfigD_t));
+    size_t dbytes = STFT_ARENA_ROUND(sizeof(double) * fftsize);
+    size_t total = head + 3 * dbytes;
+
+    char *arena = (char *)pffft_aligned_malloc(total);
+    if (!arena) {
+        STFT_ERR("Allocation failed for STFT config arena.\n");
+        return NULL;
+    }
+
+    STFT_ConfigD_t *config = (STFT_ConfigD_t *)arena;
+    config->hop = hop;
+    config->win = win;
+    config->insize = insize;
+    config->outsize = outsize;
+    config->fftsize = fftsize;
+    config->winvals = (double *)(arena + head);
+    config->re = (double *)(arena + head + dbytes);
+    config->im = (double *)(arena + head + 2 * dbytes);
+
+    config->pwin = stft_window_acquire(fftsize, wintype);
+    if (!config->pwin) {
+        pffft_aligned_free(arena);
+        return NULL;
+    }
+    for (size_t k = 0; k < fftsize; ++k) {
+        config->winvals[k] = (double)config->pwin->values[k];
+    }
+
+    return config;
+}
+
+void stft_config_deinit_d(STFT_ConfigD_t *config) {
+    if (!config)
+        return;
+    if (config->pwin)
+        stft_window_release(config->pwin);
+    pffft_aligned_free(config);
+}
+
+void stft_fft_d(double *re, double *im, size_t n) {
+    /* Bit-reversal permutation. */
+    for (size_t i = 1, j = 0; i < n; ++i) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j |= bit;
+        if (i < j) {
+            double t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    /* Iterative Cooley-Tukey butterflies. */
+    for (size_t len = 2; len <= n; len <<= 1) {
+        double ang = -2.0 * PI / (double)len;
+        double wr = cos(ang);
+        double wi = sin(ang);
+        for (size_t s = 0; s < n; s += len) {
+            double cr = 1.0;
+            double ci = 0.0;
+            for (size_t k = 0; k < len / 2; ++k) {
+                size_t a = s + k;
+                size_t b = a + len / 2;
+                double tr = re[b] * cr - im[b] * ci;
+                double ti = re[b] * ci + im[b] * cr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+                double ncr = cr * wr - ci * wi;
+                ci = cr * wi + ci * wr;
+                cr = ncr;
+            }
+        }
+    }
+}
+
+int stft_compute_d(STFT_ConfigD_t *config, const double *input,
+                   ComplexD_t **output) {
+    if (!config || !input || !output) {
+        STFT_ERR("Null pointer passed to stft_compute_d.\n");
+        return -1;
+    }
+
+#if defined(STFT_DEBUG)
+    assert(config->pwin && config->winvals && config->re && config->im);
+#endif
+
+    size_t fftsize = config->fftsize;
+    size_t half = fftsize / 2;
+
+    for (size_t i = 0; i < config->outsize; ++i) {
+        const double *src = input + i * config->hop;
+
+        for (size_t k = 0; k < config->win; ++k) {
+            config->re[k] = src[k] * config->winvals[k];
+        }
+        memset(config->re + config->win, 0,
+               sizeof(double) * (fftsize - config->win));
+        memset(config->im, 0, sizeof(double) * fftsize);
+
+        stft_fft_d(config->re, config->im, fftsize);
+
+        /* A real input gives conjugate symmetry; keep bins 0..fftsize/2.
+         * DC and Nyquist imaginary parts are exactly zero by symmetry but
+         * clamped anyway to honor the STFT_BINS contract. */
+        for (size_t k = 0; k <= half; ++k) {
+            output[i][k].re = config->re[k];
+            output[i][k].im = config->im[k];
+        }
+        output[i][0].im = 0.0;
+        output[i][half].im = 0.0;
+    }
+
+    return 0;
+}
+
 #if defined(STFT_DEBUG)
 /** @brief Debug print of complex number. */
 void print_complex(Complex_t a) { printf("%.3f + %.3fi\n", a.re, a.im); }
@@ -81,19 +81,27 @@ void save_signal(const char *filename, float *signal, size_t length,
     printf("Signal saved to %s\n", filename);
 }
 
-void dump_stft_output(const char *filename, Complex_t **output, size_t rows,
-                      size_t cols) {
-    FILE *fp = fopen(filename, "wb");
-    if (!fp) {
+/**
+ * @brief Stream the spectrogram to disk frame by frame (self-describing
+ * header, see STFT_FileHeader_t).
+ */
+int dump_stft_output(const char *filename, const STFT_Config_t *config,
+                     Complex_t **output) {
+    STFT_Writer_t *writer = stft_writer_open(filename, config);
+    if (!writer) {
         fprintf(stderr, "Failed to open %s for writing.\n", filename);
-        return;
+        return -1;
     }
 
-    for (size_t i = 0; i < rows; i++) {
-        fwrite(output[i], sizeof(Complex_t), cols, fp);
+    for (size_t i = 0; i < config->outsize; i++) {
+        if (stft_writer_append(writer, output[i]) != 0) {
+            fprintf(stderr, "Failed to append frame %zu.\n", i);
+            stft_writer_close(writer);
+            return -1;
+        }
     }
 
-    fclose(fp);
+    return stft_writer_close(writer);
 }
 
 /**
@@ -105,7 +113,7 @@ Complex_t **allocate_stft_output(size_t outsize, size_t fftsize) {
         return NULL;
 
     for (size_t i = 0; i < outsize; i++) {
-        output[i] = (Complex_t *)malloc((fftsize / 2) * sizeof(Complex_t));
+        output[i] = (Complex_t *)malloc(STFT_BINS(fftsize) * sizeof(Complex_t));
         if (!output[i]) {
             // Clean up on failure
             for (size_t j = 0; j < i; j++) {
@@ -187,8 +195,9 @@ int main() {
     }
 
     // Save output
-    dump_stft_output("stft_out.bin", output, config->outsize,
-                     config->fftsize / 2);
+    if (dump_stft_output("stft_out.bin", config, output) != 0) {
+        fprintf(stderr, "Failed to dump STFT output.\n");
+    }
 
     printf("STFT output saved to stft_out.bin\n");
 
@@ -16,13 +16,15 @@
 #include <assert.h>
 #include <math.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
 #include <time.h>
 
-// Enable debug mode for testing
+// Enable debug mode and hot-path counters for testing
 #define STFT_DEBUG
+#define STFT_STATS
 #include "stft.h"
 
 // Test configuration
@@ -207,17 +209,17 @@ void test_stft_compute_basic() {
     // Allocate output
     Complex_t **output = malloc(config->outsize * sizeof(Complex_t *));
     for (size_t i = 0; i < config->outsize; i++) {
-        output[i] = malloc(config->fftsize * sizeof(Complex_t));
+        output[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
     }
 
     // Compute STFT
     int result = stft_compute(config, input, output);
     TEST_ASSERT(result == 0, "STFT computation successful");
 
-    // Check that output is not all zeros
+    // Check that output is not all zeros (rows hold STFT_BINS(fftsize) bins)
     bool has_non_zero = false;
     for (size_t i = 0; i < config->outsize && !has_non_zero; i++) {
-        for (size_t j = 0; j < config->fftsize && !has_non_zero; j++) {
+        for (size_t j = 0; j < STFT_BINS(config->fftsize) && !has_non_zero; j++) {
             if (cabs(output[i][j]) > TEST_TOLERANCE) {
                 has_non_zero = true;
             }
@@ -255,7 +257,7 @@ void test_stft_frequency_detection() {
     // Allocate output
     Complex_t **output = malloc(config->outsize * sizeof(Complex_t *));
     for (size_t i = 0; i < config->outsize; i++) {
-        output[i] = malloc(config->fftsize * sizeof(Complex_t));
+        output[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
     }
 
     // Compute STFT
@@ -267,7 +269,7 @@ void test_stft_frequency_detection() {
     float max_magnitude = 0.0f;
     size_t max_bin = 0;
 
-    for (size_t j = 0; j < config->fftsize / 2; j++) {
+    for (size_t j = 0; j < STFT_BINS(config->fftsize); j++) {
         float magnitude = cabs(output[0][j]);
         if (magnitude > max_magnitude) {
             max_magnitude = magnitude;
@@ -306,7 +308,7 @@ void test_stft_edge_cases() {
     float *zero_input = calloc(1024, sizeof(float));
     Complex_t **output = malloc(config->outsize * sizeof(Complex_t *));
     for (size_t i = 0; i < config->outsize; i++) {
-        output[i] = malloc(config->fftsize * sizeof(Complex_t));
+        output[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
     }
 
     result = stft_compute(config, zero_input, output);
@@ -317,7 +319,7 @@ void test_stft_edge_cases() {
     int noise_count = 0;
     float checksum = 0.0f;
     for (size_t i = 0; i < config->outsize; i++) {
-        for (size_t j = 0; j < config->fftsize; j++) {
+        for (size_t j = 0; j < STFT_BINS(config->fftsize); j++) {
             if (cabs(output[i][j]) > TEST_TOLERANCE) {
                 all_near_zero = false;
                 noise_count++;
@@ -365,7 +367,7 @@ void test_stft_different_window_types() {
             // Allocate output
             Complex_t **output = malloc(config->outsize * sizeof(Complex_t *));
             for (size_t i = 0; i < config->outsize; i++) {
-                output[i] = malloc(config->fftsize * sizeof(Complex_t));
+                output[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
             }
 
             // Compute STFT
@@ -385,6 +387,2180 @@ void test_stft_different_window_types() {
     }
 }
 
+void test_stft_batch_mode() {
+    TEST_SECTION("Batched Unordered FFT Mode Tests");
+
+    const size_t input_size = 2048;
+    const size_t window_size = 512;
+    const size_t hop_size = 256;
+
+    STFT_Config_t *ordered =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    STFT_Config_t *batch = stft_config_init(hop_size, window_size, input_size,
+                                            HAMMING, STFT_FFT_BATCH);
+    TEST_ASSERT(ordered != NULL && batch != NULL,
+                "Ordered and batch configurations created");
+    if (!ordered || !batch) {
+        stft_config_deinit(ordered);
+        stft_config_deinit(batch);
+        return;
+    }
+
+    float *input = malloc(input_size * sizeof(float));
+    generate_sine_wave(input, input_size, 100.0f, 1000.0f);
+
+    Complex_t **expected = malloc(ordered->outsize * sizeof(Complex_t *));
+    Complex_t **actual = malloc(batch->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < ordered->outsize; i++) {
+        expected[i] = malloc(STFT_BINS(ordered->fftsize) * sizeof(Complex_t));
+        actual[i] = malloc(STFT_BINS(batch->fftsize) * sizeof(Complex_t));
+    }
+
+    TEST_ASSERT(stft_compute(ordered, input, expected) == 0,
+                "Ordered STFT computation");
+    TEST_ASSERT(stft_compute(batch, input, actual) == 0,
+                "Batch STFT computation");
+
+    // The batch mode must produce bit-identical ordered output
+    bool identical = true;
+    for (size_t i = 0; i < ordered->outsize; i++) {
+        if (memcmp(expected[i], actual[i],
+                   STFT_BINS(ordered->fftsize) * sizeof(Complex_t)) != 0) {
+            identical = false;
+        }
+    }
+    TEST_ASSERT(identical, "Batch mode output matches ordered mode");
+
+    // Batch mode stages through internal scratch when a row is not
+    // 16-byte aligned; output must still match the ordered reference.
+    Complex_t **misaligned = malloc(batch->outsize * sizeof(Complex_t *));
+    char **misaligned_base = malloc(batch->outsize * sizeof(char *));
+    for (size_t i = 0; i < batch->outsize; i++) {
+        misaligned_base[i] =
+            malloc(STFT_BINS(batch->fftsize) * sizeof(Complex_t) + 8);
+        misaligned[i] = (Complex_t *)(misaligned_base[i] + 8);
+    }
+
+    TEST_ASSERT(stft_compute(batch, input, misaligned) == 0,
+                "Batch STFT computation into misaligned rows");
+
+    identical = true;
+    for (size_t i = 0; i < batch->outsize; i++) {
+        if (memcmp(expected[i], misaligned[i],
+                   STFT_BINS(batch->fftsize) * sizeof(Complex_t)) != 0) {
+            identical = false;
+        }
+    }
+    TEST_ASSERT(identical, "Misaligned batch output matches ordered mode");
+
+    // Cleanup
+    for (size_t i = 0; i < ordered->outsize; i++) {
+        free(expected[i]);
+        free(actual[i]);
+        free(misaligned_base[i]);
+    }
+    free(expected);
+    free(actual);
+    free(misaligned);
+    free(misaligned_base);
+    free(input);
+    stft_config_deinit(ordered);
+    stft_config_deinit(batch);
+}
+
+void test_window_float_coefficients() {
+    TEST_SECTION("Float Window Coefficient Tests");
+
+    Window *pwin = window_init(512, HAMMING);
+    TEST_ASSERT(pwin != NULL, "Window allocated");
+    if (!pwin)
+        return;
+
+    TEST_ASSERT(window_fill(pwin) == 0, "Window filled");
+    TEST_ASSERT(pwin->fvalues != NULL, "Float coefficient array present");
+    TEST_ASSERT(((uintptr_t)pwin->fvalues % WINDOW_ALIGN) == 0,
+                "Float coefficients SIMD-aligned");
+
+    // fvalues mirrors values regardless of what WTYPE resolves to
+    bool mirrored = true;
+    for (int i = 0; i < pwin->size; i++) {
+        if (fabs((double)pwin->fvalues[i] - (double)pwin->values[i]) > 1e-6) {
+            mirrored = false;
+        }
+    }
+    TEST_ASSERT(mirrored, "fvalues mirrors values");
+
+    window_deinit(pwin);
+}
+
+void test_gather_window_kernel() {
+    TEST_SECTION("Fused Gather-Window Kernel Tests");
+
+    const size_t win = 300; // deliberately not a multiple of the SIMD width
+    const size_t fftsize = 512;
+
+    float *src = malloc(win * sizeof(float));
+    float *winvals = malloc(win * sizeof(float));
+    float *dst = malloc(fftsize * sizeof(float));
+    float *expected = malloc(fftsize * sizeof(float));
+
+    generate_noise(src, win, 1.0f);
+    generate_noise(winvals, win, 1.0f);
+    memset(dst, 0xAA, fftsize * sizeof(float)); // poison the destination
+
+    // Naive reference
+    for (size_t k = 0; k < win; k++) {
+        expected[k] = src[k] * winvals[k];
+    }
+    for (size_t k = win; k < fftsize; k++) {
+        expected[k] = 0.0f;
+    }
+
+    stft_gather_window(src, winvals, dst, win, fftsize);
+
+    TEST_ASSERT(memcmp(dst, expected, fftsize * sizeof(float)) == 0,
+                "Kernel matches naive multiply with zero-padded tail");
+
+    // win == fftsize: no tail to clear
+    memset(dst, 0, fftsize * sizeof(float));
+    stft_gather_window(src, winvals, dst, win, win);
+    TEST_ASSERT(memcmp(dst, expected, win * sizeof(float)) == 0,
+                "Kernel handles win == fftsize");
+
+    free(src);
+    free(winvals);
+    free(dst);
+    free(expected);
+}
+
+void test_stft_flat_output() {
+    TEST_SECTION("Flat Contiguous Output Tests");
+
+    const size_t input_size = 2048;
+    const size_t window_size = 512;
+    const size_t hop_size = 256;
+
+    STFT_Config_t *config =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Configuration created for flat output test");
+    if (!config)
+        return;
+
+    size_t stride = stft_row_stride(config);
+    TEST_ASSERT(stride >= STFT_BINS(config->fftsize), "Row stride covers all bins");
+    TEST_ASSERT(stride % pffft_simd_size() == 0,
+                "Row stride padded to SIMD width");
+    TEST_ASSERT(stft_row_stride(NULL) == 0, "Null config gives zero stride");
+
+    float *input = malloc(input_size * sizeof(float));
+    generate_sine_wave(input, input_size, 100.0f, 1000.0f);
+
+    // Row-pointer reference
+    Complex_t **rows = malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        rows[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
+    }
+    stft_compute(config, input, rows);
+
+    // Flat computation in one allocation
+    Complex_t *flat = stft_output_alloc(config);
+    TEST_ASSERT(flat != NULL, "Flat output block allocated");
+    TEST_ASSERT(stft_compute_flat(config, input, flat) == 0,
+                "Flat STFT computation");
+
+    bool identical = true;
+    for (size_t i = 0; i < config->outsize; i++) {
+        if (memcmp(rows[i], flat + i * stride,
+                   STFT_BINS(config->fftsize) * sizeof(Complex_t)) != 0) {
+            identical = false;
+        }
+    }
+    TEST_ASSERT(identical, "Flat output matches row-pointer output");
+
+    TEST_ASSERT(stft_compute_flat(config, NULL, flat) == -1,
+                "Null input rejected");
+
+    // Batch mode through the flat path
+    STFT_Config_t *batch = stft_config_init(hop_size, window_size, input_size,
+                                            HAMMING, STFT_FFT_BATCH);
+    if (batch) {
+        Complex_t *flat_batch = stft_output_alloc(batch);
+        TEST_ASSERT(stft_compute_flat(batch, input, flat_batch) == 0,
+                    "Flat batch-mode computation");
+        bool batch_same = true;
+        for (size_t i = 0; i < batch->outsize; i++) {
+            if (memcmp(rows[i], flat_batch + i * stride,
+                       STFT_BINS(batch->fftsize) * sizeof(Complex_t)) != 0) {
+                batch_same = false;
+            }
+        }
+        TEST_ASSERT(batch_same, "Flat batch output matches reference");
+        pffft_aligned_free(flat_batch);
+        stft_config_deinit(batch);
+    }
+
+    // Cleanup
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(rows[i]);
+    }
+    free(rows);
+    pffft_aligned_free(flat);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_stft_mmap_input() {
+    TEST_SECTION("Memory-Mapped Input Tests");
+
+    const size_t input_size = 2048;
+    const size_t window_size = 512;
+    const size_t hop_size = 256;
+    const char *path = "/tmp/stft_test_signal.bin";
+
+    STFT_Config_t *config =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    if (!config)
+        return;
+
+    float *input = malloc(input_size * sizeof(float));
+    generate_sine_wave(input, input_size, 100.0f, 1000.0f);
+
+    // Write the signal out as raw float32 PCM
+    FILE *fp = fopen(path, "wb");
+    TEST_ASSERT(fp != NULL, "Signal file created");
+    if (fp) {
+        fwrite(input, sizeof(float), input_size, fp);
+        fclose(fp);
+    }
+
+    Complex_t **expected = malloc(config->outsize * sizeof(Complex_t *));
+    Complex_t **actual = malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        expected[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
+        actual[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
+    }
+
+    stft_compute(config, input, expected);
+    TEST_ASSERT(stft_compute_mmap(config, path, actual) == 0,
+                "Memory-mapped STFT computation");
+
+    bool identical = true;
+    for (size_t i = 0; i < config->outsize; i++) {
+        if (memcmp(expected[i], actual[i],
+                   STFT_BINS(config->fftsize) * sizeof(Complex_t)) != 0) {
+            identical = false;
+        }
+    }
+    TEST_ASSERT(identical, "Memory-mapped output matches in-memory output");
+
+    TEST_ASSERT(stft_compute_mmap(config, "/nonexistent/file", actual) == -1,
+                "Missing file rejected");
+
+    // Truncated file (fewer samples than insize) must be rejected
+    fp = fopen(path, "wb");
+    if (fp) {
+        fwrite(input, sizeof(float), input_size / 2, fp);
+        fclose(fp);
+    }
+    TEST_ASSERT(stft_compute_mmap(config, path, actual) == -1,
+                "Truncated file rejected");
+
+    // Cleanup
+    remove(path);
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(expected[i]);
+        free(actual[i]);
+    }
+    free(expected);
+    free(actual);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_stft_spectra_outputs() {
+    TEST_SECTION("Magnitude/Power/dB Output Tests");
+
+    const size_t input_size = 2048;
+    const size_t window_size = 512;
+    const size_t hop_size = 256;
+
+    STFT_Config_t *config =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    if (!config)
+        return;
+
+    float *input = malloc(input_size * sizeof(float));
+    generate_sine_wave(input, input_size, 100.0f, 1000.0f);
+
+    // Complex reference
+    Complex_t **complex_out = malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        complex_out[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
+    }
+    stft_compute(config, input, complex_out);
+
+    size_t bins = STFT_BINS(config->fftsize);
+    float *mag = malloc(config->outsize * bins * sizeof(float));
+    float *power = malloc(config->outsize * bins * sizeof(float));
+    float *db = malloc(config->outsize * bins * sizeof(float));
+
+    TEST_ASSERT(stft_compute_spectra(config, input, mag,
+                                     STFT_OUT_MAGNITUDE) == 0,
+                "Magnitude spectrogram computed");
+    TEST_ASSERT(stft_compute_spectra(config, input, power, STFT_OUT_POWER) ==
+                    0,
+                "Power spectrogram computed");
+    TEST_ASSERT(stft_compute_spectra(config, input, db, STFT_OUT_DB) == 0,
+                "dB spectrogram computed");
+
+    // Cross-check against the scalar cabs post-pass (skip packed bin 0)
+    bool mag_ok = true, pow_ok = true, db_ok = true;
+    for (size_t i = 0; i < config->outsize; i++) {
+        for (size_t j = 1; j < bins; j++) {
+            float m = cabs(complex_out[i][j]);
+            float got_m = mag[i * bins + j];
+            float got_p = power[i * bins + j];
+            float got_d = db[i * bins + j];
+            if (fabsf(got_m - m) > 1e-3f * (1.0f + m))
+                mag_ok = false;
+            if (fabsf(got_p - m * m) > 1e-2f * (1.0f + m * m))
+                pow_ok = false;
+            if (fabsf(got_d - 20.0f * log10f(m + STFT_DB_EPS)) > 1e-2f)
+                db_ok = false;
+        }
+    }
+    TEST_ASSERT(mag_ok, "Magnitude matches scalar cabs post-pass");
+    TEST_ASSERT(pow_ok, "Power matches squared magnitude");
+    TEST_ASSERT(db_ok, "dB matches 20*log10 of magnitude");
+
+    TEST_ASSERT(stft_compute_spectra(config, input, mag, STFT_OUT_COMPLEX) ==
+                    -1,
+                "Complex kind rejected (use stft_compute)");
+
+    // Cleanup
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(complex_out[i]);
+    }
+    free(complex_out);
+    free(mag);
+    free(power);
+    free(db);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_istft_roundtrip() {
+    TEST_SECTION("Inverse STFT Round-Trip Tests");
+
+    const size_t input_size = 2048;
+    const size_t window_size = 512;
+    const size_t hop_size = 128;
+
+    STFT_Config_t *config =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    if (!config)
+        return;
+
+    float *input = malloc(input_size * sizeof(float));
+    float *reconstructed = malloc(input_size * sizeof(float));
+    generate_sine_wave(input, input_size, 440.0f, 8000.0f);
+
+    Complex_t **frames = malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        frames[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
+    }
+
+    TEST_ASSERT(stft_compute(config, input, frames) == 0,
+                "Forward STFT computed");
+    TEST_ASSERT(istft_compute(config, frames, reconstructed) == 0,
+                "Inverse STFT computed");
+
+    // Per-sample COLA normalization makes every covered sample exact (the
+    // Hamming window is nonzero at its edges, so coverage is complete).
+    float max_err = 0.0f;
+    for (size_t n = 0; n < input_size; n++) {
+        float err = fabsf(reconstructed[n] - input[n]);
+        if (err > max_err)
+            max_err = err;
+    }
+    TEST_ASSERT(max_err < 1e-3f, "Reconstruction matches input signal");
+
+    // Overlap-add kernel sanity: dst += src * win on an unaligned tail
+    float dst[7] = {1, 1, 1, 1, 1, 1, 1};
+    float src[7] = {1, 2, 3, 4, 5, 6, 7};
+    float wvals[7] = {0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f};
+    stft_overlap_add(dst, src, wvals, 7);
+    bool ola_ok = true;
+    for (size_t k = 0; k < 7; k++) {
+        if (fabsf(dst[k] - (1.0f + 0.5f * src[k])) > 1e-6f)
+            ola_ok = false;
+    }
+    TEST_ASSERT(ola_ok, "Overlap-add kernel handles unaligned lengths");
+
+    // Invalid parameter handling
+    TEST_ASSERT(istft_compute(NULL, frames, reconstructed) == -1,
+                "NULL config rejected");
+    TEST_ASSERT(istft_compute(config, NULL, reconstructed) == -1,
+                "NULL frames rejected");
+    TEST_ASSERT(istft_compute(config, frames, NULL) == -1,
+                "NULL output rejected");
+
+    // Cleanup
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(frames[i]);
+    }
+    free(frames);
+    free(input);
+    free(reconstructed);
+    stft_config_deinit(config);
+}
+
+void test_checked_unchecked_api() {
+    TEST_SECTION("Checked/Unchecked API Tests");
+
+    const size_t hop = 128;
+    const size_t win = 512;
+    const size_t input_size = 4096;
+
+    STFT_Config_t *config =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation for tier test");
+    if (!config)
+        return;
+
+    const size_t bins = STFT_BINS(config->fftsize);
+
+    TEST_ASSERT(stft_validate(config) == 0, "Fresh config validates");
+    TEST_ASSERT(stft_validate(NULL) == -1, "NULL config fails validation");
+
+    // Geometry tampering is caught up front, not mid-batch
+    size_t good_outsize = config->outsize;
+    config->outsize = good_outsize + 10; // final frame would overrun insize
+    TEST_ASSERT(stft_validate(config) == -1,
+                "Overrunning frame count fails validation");
+
+    float *input = (float *)malloc(input_size * sizeof(float));
+    for (size_t i = 0; i < input_size; i++) {
+        input[i] = sinf(2.0f * PI * 440.0f * i / 8000.0f);
+    }
+    Complex_t **rows = (Complex_t **)malloc(good_outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < good_outsize; i++) {
+        rows[i] = (Complex_t *)malloc(bins * sizeof(Complex_t));
+    }
+
+    TEST_ASSERT(stft_compute(config, input, rows) == -1,
+                "Checked compute rejects tampered geometry");
+
+    config->outsize = good_outsize;
+    TEST_ASSERT(stft_compute(config, input, rows) == 0,
+                "Checked compute succeeds after restore");
+
+    // Unchecked per-frame path reproduces the batch rows exactly
+    Complex_t *frame = (Complex_t *)malloc(bins * sizeof(Complex_t));
+    bool match = true;
+    for (size_t i = 0; i < good_outsize; i++) {
+        stft_compute_frame_unsafe(config, input + i * hop, frame);
+        if (memcmp(frame, rows[i], bins * sizeof(Complex_t)) != 0)
+            match = false;
+    }
+    TEST_ASSERT(match, "Unchecked frame path matches checked batch");
+
+    // Validation covers the degenerate hop case too
+    size_t good_hop = config->hop;
+    config->hop = 0;
+    TEST_ASSERT(stft_validate(config) == -1, "Zero hop fails validation");
+    config->hop = good_hop;
+
+    for (size_t i = 0; i < good_outsize; i++) {
+        free(rows[i]);
+    }
+    free(rows);
+    free(frame);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_filterbank() {
+    TEST_SECTION("Filterbank Tests");
+
+    const size_t hop = 256;
+    const size_t win = 1024;
+    const size_t input_size = 8192;
+    const size_t nbands = 40;
+    const float sample_rate = 8000.0f;
+
+    STFT_Config_t *config =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation for filterbank test");
+    if (!config)
+        return;
+
+    const size_t bins = STFT_BINS(config->fftsize);
+
+    TEST_ASSERT(stft_set_mel_filterbank(config, nbands, sample_rate, 0.0f,
+                                        4000.0f) == 0,
+                "Mel filterbank attachment succeeds");
+    TEST_ASSERT(config->nbands == nbands, "Band count recorded");
+
+    // Every stored weight is a valid triangle sample
+    bool weights_ok = true;
+    for (size_t b = 0; b < nbands; b++) {
+        if (config->fb_len[b] == 0)
+            continue;
+        for (size_t j = 0; j < config->fb_len[b]; j++) {
+            float w = config->fb_weights[config->fb_off[b] + j];
+            if (w <= 0.0f || w > 1.0f)
+                weights_ok = false;
+        }
+        if (config->fb_start[b] + config->fb_len[b] > bins)
+            weights_ok = false;
+    }
+    TEST_ASSERT(weights_ok, "Stored weights are in (0, 1] and in range");
+
+    float *input = (float *)malloc(input_size * sizeof(float));
+    for (size_t i = 0; i < input_size; i++) {
+        input[i] = sinf(2.0f * PI * 440.0f * i / sample_rate) +
+                   0.5f * sinf(2.0f * PI * 2000.0f * i / sample_rate);
+    }
+
+    float *bands = (float *)malloc(config->outsize * nbands * sizeof(float));
+    TEST_ASSERT(stft_compute_bands(config, input, bands) == 0,
+                "Fused band compute succeeds");
+
+    // Reference: full spectrum, then the same filters applied manually
+    Complex_t **full = (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        full[i] = (Complex_t *)malloc(bins * sizeof(Complex_t));
+    }
+    TEST_ASSERT(stft_compute(config, input, full) == 0,
+                "Full reference compute succeeds");
+
+    float max_rel = 0.0f;
+    for (size_t i = 0; i < config->outsize; i++) {
+        for (size_t b = 0; b < nbands; b++) {
+            float expect = 0.0f;
+            for (size_t j = 0; j < config->fb_len[b]; j++) {
+                size_t k = config->fb_start[b] + j;
+                float p = full[i][k].re * full[i][k].re +
+                          full[i][k].im * full[i][k].im;
+                expect += config->fb_weights[config->fb_off[b] + j] * p;
+            }
+            float got = bands[i * nbands + b];
+            float rel = fabsf(got - expect) / (fabsf(expect) + 1e-3f);
+            if (rel > max_rel)
+                max_rel = rel;
+        }
+    }
+    TEST_ASSERT(max_rel < 1e-4f,
+                "Fused band energies match spectrum-then-filter");
+
+    // The 440 Hz tone dominates a low band, 2 kHz a higher one
+    size_t peak_low = 0, peak_high = 0;
+    float best = -1.0f;
+    for (size_t b = 0; b < nbands; b++) {
+        if (bands[4 * nbands + b] > best) {
+            best = bands[4 * nbands + b];
+            peak_low = b;
+        }
+    }
+    best = -1.0f;
+    for (size_t b = peak_low + 1; b < nbands; b++) {
+        if (bands[4 * nbands + b] > best) {
+            best = bands[4 * nbands + b];
+            peak_high = b;
+        }
+    }
+    TEST_ASSERT(peak_low < peak_high && peak_high < nbands,
+                "Tone energies land in distinct ordered bands");
+
+    // Arbitrary band edges work through the generic entry point
+    float edges[5] = {100.0f, 400.0f, 900.0f, 1600.0f, 2500.0f};
+    TEST_ASSERT(stft_set_filterbank(config, edges, 3, sample_rate) == 0,
+                "Arbitrary edge filterbank attachment succeeds");
+    TEST_ASSERT(config->nbands == 3, "Replaced bank has new band count");
+    TEST_ASSERT(stft_compute_bands(config, input, bands) == 0,
+                "Compute with replaced bank succeeds");
+
+    // Invalid parameter handling
+    float bad_edges[5] = {100.0f, 90.0f, 900.0f, 1600.0f, 2500.0f};
+    TEST_ASSERT(stft_set_filterbank(config, bad_edges, 3, sample_rate) == -1,
+                "Non-ascending edges rejected");
+    TEST_ASSERT(stft_set_mel_filterbank(config, 0, sample_rate, 0.0f,
+                                        4000.0f) == -1,
+                "Zero band count rejected");
+    TEST_ASSERT(stft_set_mel_filterbank(config, nbands, sample_rate, 0.0f,
+                                        5000.0f) == -1,
+                "fmax beyond Nyquist rejected");
+    TEST_ASSERT(stft_compute_bands(NULL, input, bands) == -1,
+                "NULL config rejected by band compute");
+
+    STFT_Config_t *plain =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(plain != NULL && stft_compute_bands(plain, input, bands) == -1,
+                "Config without filterbank rejected");
+    stft_config_deinit(plain);
+
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(full[i]);
+    }
+    free(full);
+    free(bands);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_cpu_dispatch() {
+    TEST_SECTION("CPU Dispatch Tests");
+
+    STFT_Config_t *config =
+        stft_config_init(128, 512, 2048, HANNING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation for dispatch test");
+    if (!config)
+        return;
+
+    TEST_ASSERT(config->kern.gather_window != NULL &&
+                    config->kern.overlap_add != NULL &&
+                    config->kern.cabs != NULL,
+                "Kernel table filled at init");
+
+    // Selected variants agree with the baseline kernels on this host
+    const size_t n = 515; // odd tail for every vector width
+    float *src = (float *)malloc(n * sizeof(float));
+    float *wv = (float *)malloc(n * sizeof(float));
+    float *a = (float *)malloc(n * sizeof(float));
+    float *b = (float *)malloc(n * sizeof(float));
+    Complex_t *cplx = (Complex_t *)malloc(n * sizeof(Complex_t));
+    srand(77);
+    for (size_t k = 0; k < n; k++) {
+        src[k] = (float)(rand() % 2000 - 1000) / 250.0f;
+        wv[k] = (float)(rand() % 1000) / 1000.0f;
+        a[k] = b[k] = (float)(rand() % 100) / 50.0f;
+        cplx[k].re = src[k];
+        cplx[k].im = wv[k] - 0.5f;
+    }
+
+    stft_gather_window(src, wv, a, n - 3, n);
+    config->kern.gather_window(src, wv, b, n - 3, n);
+    TEST_ASSERT(memcmp(a, b, n * sizeof(float)) == 0,
+                "Dispatched gather matches baseline");
+
+    memcpy(a, src, n * sizeof(float));
+    memcpy(b, src, n * sizeof(float));
+    stft_overlap_add(a, src, wv, n);
+    config->kern.overlap_add(b, src, wv, n);
+    bool ola_ok = true;
+    for (size_t k = 0; k < n; k++) {
+        if (fabsf(a[k] - b[k]) > 1e-5f)
+            ola_ok = false;
+    }
+    TEST_ASSERT(ola_ok, "Dispatched overlap-add matches baseline");
+
+    cabs_vec(cplx, a, n);
+    config->kern.cabs(cplx, b, n);
+    bool mag_ok = true;
+    for (size_t k = 0; k < n; k++) {
+        if (fabsf(a[k] - b[k]) > 1e-5f)
+            mag_ok = false;
+    }
+    TEST_ASSERT(mag_ok, "Dispatched magnitude matches baseline");
+
+    free(src);
+    free(wv);
+    free(a);
+    free(b);
+    free(cplx);
+    stft_config_deinit(config);
+}
+
+void test_sparse_bins() {
+    TEST_SECTION("Sparse Bin Query Tests");
+
+    const size_t hop = 256;
+    const size_t win = 1024;
+    const size_t input_size = 8192;
+
+    STFT_Config_t *config =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation for sparse test");
+    if (!config)
+        return;
+
+    const size_t bins = STFT_BINS(config->fftsize);
+
+    // Alarm-tone style bin set including the DC and Nyquist edges
+    size_t targets[6] = {0, 56, 128, 300, 333, bins - 1};
+    TEST_ASSERT(stft_register_bins(config, targets, 6) == 0,
+                "Bin registration succeeds");
+    TEST_ASSERT(config->nqbins == 6, "Registered bin count recorded");
+
+    float *input = (float *)malloc(input_size * sizeof(float));
+    for (size_t i = 0; i < input_size; i++) {
+        input[i] = sinf(2.0f * PI * 440.0f * i / 8000.0f) +
+                   0.5f * sinf(2.0f * PI * 2600.0f * i / 8000.0f) + 0.1f;
+    }
+
+    Complex_t **full = (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    Complex_t **sparse =
+        (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        full[i] = (Complex_t *)malloc(bins * sizeof(Complex_t));
+        sparse[i] = (Complex_t *)malloc(6 * sizeof(Complex_t));
+    }
+
+    TEST_ASSERT(stft_compute(config, input, full) == 0,
+                "Full reference compute succeeds");
+    TEST_ASSERT(stft_compute_sparse(config, input, sparse) == 0,
+                "Sparse compute succeeds");
+
+    // Goertzel values agree with the corresponding FFT bins
+    float max_err = 0.0f;
+    for (size_t i = 0; i < config->outsize; i++) {
+        for (size_t j = 0; j < 6; j++) {
+            Complex_t a = sparse[i][j];
+            Complex_t b = full[i][targets[j]];
+            float err = cabs((Complex_t){a.re - b.re, a.im - b.im});
+            if (err > max_err)
+                max_err = err;
+        }
+    }
+    TEST_ASSERT(max_err < 1e-2f, "Sparse bins match full transform bins");
+
+    // Re-registration replaces the previous set
+    size_t single = 56;
+    TEST_ASSERT(stft_register_bins(config, &single, 1) == 0,
+                "Re-registration succeeds");
+    TEST_ASSERT(config->nqbins == 1, "Replaced set has new count");
+    TEST_ASSERT(stft_compute_sparse(config, input, sparse) == 0,
+                "Sparse compute with replaced set succeeds");
+    TEST_ASSERT(cabs((Complex_t){sparse[3][0].re - full[3][56].re,
+                                 sparse[3][0].im - full[3][56].im}) < 1e-2f,
+                "Replaced set still matches the full transform");
+
+    // Invalid parameter handling
+    size_t bad = bins;
+    TEST_ASSERT(stft_register_bins(config, &bad, 1) == -1,
+                "Out-of-range bin rejected");
+    TEST_ASSERT(stft_register_bins(config, targets, 0) == -1,
+                "Zero bin count rejected");
+    TEST_ASSERT(stft_register_bins(NULL, targets, 6) == -1,
+                "NULL config rejected by register");
+    TEST_ASSERT(stft_compute_sparse(NULL, input, sparse) == -1,
+                "NULL config rejected by sparse compute");
+
+    // A config without registered bins refuses sparse queries
+    STFT_Config_t *plain =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(plain != NULL &&
+                    stft_compute_sparse(plain, input, sparse) == -1,
+                "Unregistered config rejected by sparse compute");
+    stft_config_deinit(plain);
+
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(full[i]);
+        free(sparse[i]);
+    }
+    free(full);
+    free(sparse);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_overlap_compute() {
+    TEST_SECTION("Overlap-Aware Compute Tests");
+
+    // 87.5% overlap: each hop block feeds 8 frames
+    const size_t hop = 64;
+    const size_t win = 512;
+    const size_t input_size = 4096;
+
+    STFT_Config_t *config =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation at hop = win/8");
+    if (!config)
+        return;
+
+    const size_t bins = STFT_BINS(config->fftsize);
+
+    float *input = (float *)malloc(input_size * sizeof(float));
+    Complex_t **ref = (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    Complex_t **ovl = (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        ref[i] = (Complex_t *)malloc(bins * sizeof(Complex_t));
+        ovl[i] = (Complex_t *)malloc(bins * sizeof(Complex_t));
+    }
+    for (size_t i = 0; i < input_size; i++) {
+        input[i] = sinf(2.0f * PI * 440.0f * i / 8000.0f) +
+                   0.5f * sinf(2.0f * PI * 2000.0f * i / 8000.0f);
+    }
+
+    TEST_ASSERT(stft_compute(config, input, ref) == 0,
+                "Frame-major reference compute succeeds");
+    TEST_ASSERT(stft_compute_overlap(config, input, ovl) == 0,
+                "Block sweep compute succeeds");
+
+    bool match = true;
+    for (size_t i = 0; i < config->outsize && match; i++) {
+        if (memcmp(ovl[i], ref[i], bins * sizeof(Complex_t)) != 0)
+            match = false;
+    }
+    TEST_ASSERT(match, "Block sweep output is bit-identical");
+
+    // Invalid parameter handling
+    TEST_ASSERT(stft_compute_overlap(NULL, input, ovl) == -1,
+                "NULL config rejected");
+    TEST_ASSERT(stft_compute_overlap(config, NULL, ovl) == -1,
+                "NULL input rejected");
+
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(ref[i]);
+        free(ovl[i]);
+    }
+    free(ref);
+    free(ovl);
+    free(input);
+    stft_config_deinit(config);
+
+    // Non-dividing hop still computes correctly via the fallback
+    config = stft_config_init(96, 512, 4096, HAMMING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation with win % hop != 0");
+    if (!config)
+        return;
+    Complex_t **out2 =
+        (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    Complex_t **ref2 =
+        (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    float *input2 = (float *)malloc(4096 * sizeof(float));
+    for (size_t i = 0; i < 4096; i++) {
+        input2[i] = sinf(2.0f * PI * 700.0f * i / 8000.0f);
+    }
+    for (size_t i = 0; i < config->outsize; i++) {
+        out2[i] = (Complex_t *)malloc(STFT_BINS(config->fftsize) *
+                                      sizeof(Complex_t));
+        ref2[i] = (Complex_t *)malloc(STFT_BINS(config->fftsize) *
+                                      sizeof(Complex_t));
+    }
+    TEST_ASSERT(stft_compute(config, input2, ref2) == 0,
+                "Fallback reference compute succeeds");
+    TEST_ASSERT(stft_compute_overlap(config, input2, out2) == 0,
+                "Non-dividing hop falls back cleanly");
+    bool match2 = true;
+    for (size_t i = 0; i < config->outsize && match2; i++) {
+        if (memcmp(out2[i], ref2[i],
+                   STFT_BINS(config->fftsize) * sizeof(Complex_t)) != 0)
+            match2 = false;
+    }
+    TEST_ASSERT(match2, "Fallback output matches stft_compute");
+
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(out2[i]);
+        free(ref2[i]);
+    }
+    free(out2);
+    free(ref2);
+    free(input2);
+    stft_config_deinit(config);
+}
+
+void test_window_recurrence() {
+    TEST_SECTION("Window Recurrence Tests");
+
+    // Odd size so the final points sit mid-way between resync points
+    const int size = 8191;
+    double *vals = (double *)malloc(size * sizeof(double));
+    TEST_ASSERT(vals != NULL, "Window value buffer allocation");
+    if (!vals)
+        return;
+
+    // Hanning against direct transcendental evaluation
+    TEST_ASSERT(fill_hanning(size, vals) == 0, "Hanning fill succeeds");
+    double max_err = 0.0;
+    for (int i = 0; i < size; i++) {
+        double direct = 0.5 - 0.5 * cos(2.0 * PI * i / (size - 1));
+        double err = fabs(vals[i] - direct);
+        if (err > max_err)
+            max_err = err;
+    }
+    TEST_ASSERT(max_err < 1e-12, "Hanning recurrence matches direct cos");
+
+    // Blackman-Harris exercises all three harmonics
+    TEST_ASSERT(fill_blkmhar(size, vals) == 0,
+                "Blackman-Harris fill succeeds");
+    max_err = 0.0;
+    for (int i = 0; i < size; i++) {
+        double direct = 0.35875 - 0.48829 * cos(2.0 * PI * i / (size - 1)) +
+                        0.14128 * cos(4.0 * PI * i / (size - 1)) +
+                        0.01168 * cos(6.0 * PI * i / (size - 1));
+        double err = fabs(vals[i] - direct);
+        if (err > max_err)
+            max_err = err;
+    }
+    TEST_ASSERT(max_err < 1e-12,
+                "Blackman-Harris recurrence matches direct cos");
+
+    // Known endpoint and symmetry properties survive the recurrence
+    TEST_ASSERT(fill_hamming(size, vals) == 0, "Hamming fill succeeds");
+    TEST_ASSERT(fabs(vals[0] - (25.0 / 46.0 - 21.0 / 46.0)) < 1e-12,
+                "Hamming left endpoint exact");
+    bool symmetric = true;
+    for (int i = 0; i < size / 2; i++) {
+        if (fabs(vals[i] - vals[size - 1 - i]) > 1e-11)
+            symmetric = false;
+    }
+    TEST_ASSERT(symmetric, "Window symmetry preserved");
+
+    TEST_ASSERT(fill_hanning(size, NULL) == -1, "NULL output rejected");
+
+    free(vals);
+}
+
+void test_window_bank_lookup() {
+    TEST_SECTION("Window Bank Lookup Tests");
+
+    // Deliberately unsorted creation order; lookup must still work
+    int sizes[] = {1024, 64, 960, 256, 4096};
+    const int nsizes = 5;
+
+    WindowBank *bank = window_bank_init(nsizes, sizes, HANNING);
+    TEST_ASSERT(bank != NULL, "Bank creation from unsorted sizes");
+    if (!bank)
+        return;
+    TEST_ASSERT(window_bank_fill(bank) == 0, "Bank fill succeeds");
+
+    // Snapshot is sorted ascending so binary search applies
+    WindowIndex *idx = atomic_load(&bank->index);
+    bool sorted = true;
+    for (int i = 1; i < idx->count; i++) {
+        if (idx->pwins[i - 1]->size >= idx->pwins[i]->size)
+            sorted = false;
+    }
+    TEST_ASSERT(sorted, "Snapshot holds sizes in ascending order");
+
+    // Every size resolves, including first and last
+    bool found = true;
+    for (int i = 0; i < nsizes; i++) {
+        Window *pwin = window_bank_get(bank, sizes[i]);
+        if (!pwin || pwin->size != sizes[i])
+            found = false;
+    }
+    TEST_ASSERT(found, "Binary search finds every bank size");
+    TEST_ASSERT(window_bank_get(bank, 512) == NULL,
+                "Absent size returns NULL");
+
+    // get_or_create: hit path returns the existing window
+    Window *existing = window_bank_get(bank, 256);
+    TEST_ASSERT(window_bank_get_or_create(bank, 256) == existing,
+                "get_or_create hit returns the cached window");
+
+    // Miss path creates, fills and indexes the window exactly once
+    Window *created = window_bank_get_or_create(bank, 512);
+    TEST_ASSERT(created != NULL && created->size == 512,
+                "get_or_create builds a missing size");
+    TEST_ASSERT(created->values != NULL &&
+                    fabs(created->values[0]) < 1e-9 &&
+                    fabs(created->values[256] - 1.0) < 1e-4,
+                "Lazily created window is filled");
+    TEST_ASSERT(window_bank_get(bank, 512) == created,
+                "Created window is findable afterwards");
+    TEST_ASSERT(window_bank_get_or_create(bank, 512) == created,
+                "Second get_or_create reuses the same window");
+
+    // The pre-existing windows survived the snapshot swap
+    TEST_ASSERT(window_bank_get(bank, 4096) != NULL &&
+                    window_bank_get(bank, 64) != NULL,
+                "Old sizes remain after a snapshot swap");
+
+    // Invalid parameter handling
+    TEST_ASSERT(window_bank_get(NULL, 256) == NULL,
+                "NULL bank rejected by get");
+    TEST_ASSERT(window_bank_get_or_create(NULL, 256) == NULL,
+                "NULL bank rejected by get_or_create");
+    TEST_ASSERT(window_bank_get_or_create(bank, 0) == NULL,
+                "Degenerate size rejected by get_or_create");
+
+    window_bank_deinit(bank);
+}
+
+void test_bulk_complex_ops() {
+    TEST_SECTION("Bulk Complex Operation Tests");
+
+    // Odd length exercises both the SIMD body and the scalar tail
+    const size_t n = 131;
+    Complex_t *a = (Complex_t *)malloc(n * sizeof(Complex_t));
+    Complex_t *b = (Complex_t *)malloc(n * sizeof(Complex_t));
+    Complex_t *acc = (Complex_t *)malloc(n * sizeof(Complex_t));
+    Complex_t *acc_ref = (Complex_t *)malloc(n * sizeof(Complex_t));
+    float *mags = (float *)malloc(n * sizeof(float));
+
+    srand(123);
+    for (size_t k = 0; k < n; k++) {
+        a[k].re = (float)(rand() % 2000 - 1000) / 100.0f;
+        a[k].im = (float)(rand() % 2000 - 1000) / 100.0f;
+        b[k].re = (float)(rand() % 2000 - 1000) / 100.0f;
+        b[k].im = (float)(rand() % 2000 - 1000) / 100.0f;
+        acc[k].re = acc_ref[k].re = (float)(rand() % 100) / 10.0f;
+        acc[k].im = acc_ref[k].im = (float)(rand() % 100) / 10.0f;
+    }
+
+    // cabs_vec against the scalar primitive
+    cabs_vec(a, mags, n);
+    bool abs_ok = true;
+    for (size_t k = 0; k < n; k++) {
+        if (fabsf(mags[k] - cabs(a[k])) > 1e-4f)
+            abs_ok = false;
+    }
+    TEST_ASSERT(abs_ok, "cabs_vec matches scalar cabs");
+
+    // cmac_vec against csum/cprod element by element
+    cmac_vec(acc, a, b, n);
+    bool mac_ok = true;
+    for (size_t k = 0; k < n; k++) {
+        Complex_t expect = csum(acc_ref[k], cprod(a[k], b[k]));
+        if (fabsf(acc[k].re - expect.re) > 1e-3f ||
+            fabsf(acc[k].im - expect.im) > 1e-3f)
+            mac_ok = false;
+    }
+    TEST_ASSERT(mac_ok, "cmac_vec matches scalar csum/cprod");
+
+    // Peak search: plant a spike, including at tail and edge positions
+    const size_t spikes[3] = {0, 77, n - 1};
+    bool peak_ok = true;
+    for (size_t s = 0; s < 3; s++) {
+        for (size_t k = 0; k < n; k++) {
+            a[k].re = 0.01f;
+            a[k].im = 0.01f;
+        }
+        a[spikes[s]].re = 50.0f;
+        a[spikes[s]].im = 10.0f;
+        float peak_mag = 0.0f;
+        size_t bin = cpeak_vec(a, n, &peak_mag);
+        if (bin != spikes[s] ||
+            fabsf(peak_mag - cabs(a[spikes[s]])) > 1e-3f)
+            peak_ok = false;
+    }
+    TEST_ASSERT(peak_ok, "cpeak_vec finds planted spikes with magnitude");
+
+    // Ties resolve to the lowest bin; NULL mag pointer is allowed
+    for (size_t k = 0; k < n; k++) {
+        a[k].re = 1.0f;
+        a[k].im = 0.0f;
+    }
+    TEST_ASSERT(cpeak_vec(a, n, NULL) == 0, "Ties resolve to lowest bin");
+
+    // Invalid parameter handling
+    TEST_ASSERT(cpeak_vec(NULL, n, NULL) == (size_t)-1,
+                "NULL input rejected by cpeak_vec");
+    TEST_ASSERT(cpeak_vec(a, 0, NULL) == (size_t)-1,
+                "Zero length rejected by cpeak_vec");
+
+    free(a);
+    free(b);
+    free(acc);
+    free(acc_ref);
+    free(mags);
+}
+
+void test_ring_frontend() {
+    TEST_SECTION("Ring Buffer Front-End Tests");
+
+    const size_t hop = 128;
+    const size_t win = 512;
+    const size_t chunk = 480; // typical fixed-size capture callback chunk
+    const size_t input_size = 4800;
+
+    STFT_Config_t *config =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation for ring test");
+    if (!config)
+        return;
+
+    const size_t bins = STFT_BINS(config->fftsize);
+
+    float *input = (float *)malloc(input_size * sizeof(float));
+    for (size_t i = 0; i < input_size; i++) {
+        input[i] = sinf(2.0f * PI * 440.0f * i / 8000.0f) +
+                   0.3f * sinf(2.0f * PI * 1200.0f * i / 8000.0f);
+    }
+
+    // Reference frames from the batch entry point
+    Complex_t **ref = (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        ref[i] = (Complex_t *)malloc(bins * sizeof(Complex_t));
+    }
+    TEST_ASSERT(stft_compute(config, input, ref) == 0,
+                "Batch reference compute succeeds");
+
+    // Small capacity (2*win) so frames regularly wrap the ring edge
+    STFT_Ring_t *ring = stft_ring_init(config, 2 * win);
+    TEST_ASSERT(ring != NULL, "Ring creation");
+    TEST_ASSERT(ring->capacity == 2 * win, "Requested capacity honoured");
+    TEST_ASSERT(stft_ring_available(ring) == 0, "Empty ring has no frames");
+
+    // Feed fixed 480-sample chunks, draining frames as they appear
+    Complex_t *frame = (Complex_t *)malloc(bins * sizeof(Complex_t));
+    size_t produced = 0;
+    bool match = true;
+    for (size_t off = 0; off + chunk <= input_size; off += chunk) {
+        TEST_ASSERT(stft_ring_push(ring, input + off, chunk) == 0,
+                    "Chunk push succeeds");
+        int rc;
+        while ((rc = stft_ring_pop(ring, frame)) == 1) {
+            if (produced < config->outsize &&
+                memcmp(frame, ref[produced], bins * sizeof(Complex_t)) != 0)
+                match = false;
+            produced++;
+        }
+        TEST_ASSERT(rc == 0, "Pop drains to empty without error");
+    }
+    TEST_ASSERT(match, "Ring frames match batch compute bit for bit");
+    TEST_ASSERT(produced >= config->outsize - win / hop,
+                "Ring produced the expected number of frames");
+
+    // Overflow is rejected without corrupting buffered samples
+    float big[2 * 512 + 1];
+    memset(big, 0, sizeof(big));
+    TEST_ASSERT(stft_ring_push(ring, big, 2 * win + 1) == -1,
+                "Oversized push rejected");
+
+    // Invalid parameter handling
+    TEST_ASSERT(stft_ring_init(NULL, 0) == NULL, "NULL config rejected");
+    TEST_ASSERT(stft_ring_push(NULL, input, chunk) == -1,
+                "NULL ring rejected by push");
+    TEST_ASSERT(stft_ring_pop(ring, NULL) == -1,
+                "NULL frame rejected by pop");
+    TEST_ASSERT(stft_ring_available(NULL) == 0,
+                "NULL ring reports no frames");
+
+    // Default capacity kicks in when 0 is passed
+    STFT_Ring_t *ring2 = stft_ring_init(config, 0);
+    TEST_ASSERT(ring2 != NULL && ring2->capacity >= win + hop,
+                "Default capacity allows forward progress");
+    stft_ring_deinit(ring2);
+
+    stft_ring_deinit(ring);
+    stft_ring_deinit(NULL); // no-op
+
+    // hop > win: available and pop must agree, so a drain loop ends
+    STFT_Config_t *gap_cfg =
+        stft_config_init(768, 512, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(gap_cfg != NULL, "Config creation with hop > win");
+    if (gap_cfg) {
+        STFT_Ring_t *gap = stft_ring_init(gap_cfg, 0);
+        TEST_ASSERT(gap != NULL, "Ring creation with hop > win");
+        stft_ring_push(gap, input, 600); // win <= fill < hop
+        TEST_ASSERT(stft_ring_available(gap) == 0,
+                    "No frame promised before the full hop is buffered");
+        TEST_ASSERT(stft_ring_pop(gap,
+                                  (Complex_t *)frame) == 0,
+                    "Pop agrees nothing is ready");
+        stft_ring_push(gap, input + 600, 200); // fill >= hop
+        TEST_ASSERT(stft_ring_available(gap) == 1,
+                    "One frame promised once the hop is buffered");
+        size_t drained = 0;
+        while (stft_ring_available(gap) > 0) {
+            if (stft_ring_pop(gap, (Complex_t *)frame) != 1)
+                break;
+            drained++;
+        }
+        TEST_ASSERT(drained == 1, "Drain loop terminates at hop > win");
+        stft_ring_deinit(gap);
+        stft_config_deinit(gap_cfg);
+    }
+
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(ref[i]);
+    }
+    free(ref);
+    free(frame);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_multichannel() {
+    TEST_SECTION("Multichannel Engine Tests");
+
+    const size_t hop = 128;
+    const size_t win = 512;
+    const size_t input_size = 2048;
+    const size_t nchannels = 3;
+    const float tones[3] = {440.0f, 1000.0f, 2500.0f};
+
+    STFT_Config_t *config =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation for multichannel test");
+    if (!config)
+        return;
+
+    const size_t bins = STFT_BINS(config->fftsize);
+
+    // Per-channel signals plus the same data interleaved
+    float *channels[3];
+    float *interleaved =
+        (float *)malloc(input_size * nchannels * sizeof(float));
+    Complex_t **multi_out[3];
+    Complex_t **ref_out[3];
+    Complex_t **ilv_out[3];
+    for (size_t c = 0; c < nchannels; c++) {
+        channels[c] = (float *)malloc(input_size * sizeof(float));
+        multi_out[c] =
+            (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+        ref_out[c] =
+            (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+        ilv_out[c] =
+            (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+        for (size_t i = 0; i < config->outsize; i++) {
+            multi_out[c][i] = (Complex_t *)malloc(bins * sizeof(Complex_t));
+            ref_out[c][i] = (Complex_t *)malloc(bins * sizeof(Complex_t));
+            ilv_out[c][i] = (Complex_t *)malloc(bins * sizeof(Complex_t));
+        }
+        for (size_t n = 0; n < input_size; n++) {
+            channels[c][n] = sinf(2.0f * PI * tones[c] * n / 8000.0f);
+            interleaved[n * nchannels + c] = channels[c][n];
+        }
+    }
+
+    // Reference: one synchronous compute per channel
+    for (size_t c = 0; c < nchannels; c++) {
+        TEST_ASSERT(stft_compute(config, channels[c], ref_out[c]) == 0,
+                    "Per-channel reference compute succeeds");
+    }
+
+    TEST_ASSERT(stft_compute_multi(config, channels, nchannels,
+                                   multi_out) == 0,
+                "Multichannel compute succeeds");
+    bool match = true;
+    for (size_t c = 0; c < nchannels && match; c++) {
+        for (size_t i = 0; i < config->outsize && match; i++) {
+            if (memcmp(multi_out[c][i], ref_out[c][i],
+                       bins * sizeof(Complex_t)) != 0)
+                match = false;
+        }
+    }
+    TEST_ASSERT(match, "Frame-major sweep matches per-channel computes");
+
+    TEST_ASSERT(stft_compute_multi_interleaved(config, interleaved, nchannels,
+                                               ilv_out) == 0,
+                "Interleaved multichannel compute succeeds");
+    match = true;
+    for (size_t c = 0; c < nchannels && match; c++) {
+        for (size_t i = 0; i < config->outsize && match; i++) {
+            if (memcmp(ilv_out[c][i], ref_out[c][i],
+                       bins * sizeof(Complex_t)) != 0)
+                match = false;
+        }
+    }
+    TEST_ASSERT(match, "Interleaved input matches per-channel computes");
+
+    // Invalid parameter handling
+    TEST_ASSERT(stft_compute_multi(NULL, channels, nchannels, multi_out) ==
+                    -1,
+                "NULL config rejected");
+    TEST_ASSERT(stft_compute_multi(config, channels, 0, multi_out) == -1,
+                "Zero channels rejected");
+    TEST_ASSERT(stft_compute_multi_interleaved(config, NULL, nchannels,
+                                               ilv_out) == -1,
+                "NULL interleaved input rejected");
+
+    for (size_t c = 0; c < nchannels; c++) {
+        for (size_t i = 0; i < config->outsize; i++) {
+            free(multi_out[c][i]);
+            free(ref_out[c][i]);
+            free(ilv_out[c][i]);
+        }
+        free(multi_out[c]);
+        free(ref_out[c]);
+        free(ilv_out[c]);
+        free(channels[c]);
+    }
+    free(interleaved);
+    stft_config_deinit(config);
+}
+
+// Callback state shared with the async pipeline worker
+typedef struct {
+    size_t frames_seen;
+    size_t last_frame;
+    bool in_order;
+    bool bins_valid;
+} AsyncCbState;
+
+static void async_frame_cb(size_t frame, const Complex_t *bins,
+                           void *userdata) {
+    AsyncCbState *st = (AsyncCbState *)userdata;
+    if (st->frames_seen > 0 && frame != st->last_frame + 1)
+        st->in_order = false;
+    if (bins == NULL)
+        st->bins_valid = false;
+    st->last_frame = frame;
+    st->frames_seen++;
+}
+
+void test_async_pipeline() {
+    TEST_SECTION("Async Pipeline Tests");
+
+    const size_t hop = 128;
+    const size_t win = 512;
+    const size_t input_size = 4096;
+
+    STFT_Config_t *config =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation for async test");
+    if (!config)
+        return;
+
+    float *input = (float *)malloc(input_size * sizeof(float));
+    Complex_t **async_out =
+        (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    Complex_t **sync_out =
+        (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        async_out[i] = (Complex_t *)malloc(STFT_BINS(config->fftsize) *
+                                           sizeof(Complex_t));
+        sync_out[i] = (Complex_t *)malloc(STFT_BINS(config->fftsize) *
+                                          sizeof(Complex_t));
+    }
+    for (size_t i = 0; i < input_size; i++) {
+        input[i] = sinf(2.0f * PI * 440.0f * i / 8000.0f) +
+                   0.5f * sinf(2.0f * PI * 1000.0f * i / 8000.0f);
+    }
+
+    // Reference result through the synchronous entry point
+    TEST_ASSERT(stft_compute(config, input, sync_out) == 0,
+                "Synchronous reference compute succeeds");
+
+    STFT_Async_t *as = stft_async_init(config, 4);
+    TEST_ASSERT(as != NULL, "Async pipeline creation");
+    if (!as)
+        return;
+
+    AsyncCbState st = {0, 0, true, true};
+    TEST_ASSERT(stft_async_submit(as, input, async_out, async_frame_cb,
+                                  &st) == 0,
+                "Batch submission succeeds");
+    TEST_ASSERT(stft_async_drain(as) == 0, "Drain reports success");
+    TEST_ASSERT(st.frames_seen == config->outsize,
+                "Callback fired once per frame");
+    TEST_ASSERT(st.in_order, "Frames completed in submission order");
+    TEST_ASSERT(st.bins_valid, "Callback received valid bin pointers");
+
+    // Async output matches the synchronous path bit for bit
+    bool match = true;
+    for (size_t i = 0; i < config->outsize && match; i++) {
+        if (memcmp(async_out[i], sync_out[i],
+                   STFT_BINS(config->fftsize) * sizeof(Complex_t)) != 0)
+            match = false;
+    }
+    TEST_ASSERT(match, "Async output matches synchronous compute");
+
+    // Multiple queued batches exercise the ring and backpressure path
+    AsyncCbState st2 = {0, 0, true, true};
+    for (size_t b = 0; b < 8; b++) {
+        TEST_ASSERT(stft_async_submit(as, input, async_out, async_frame_cb,
+                                      &st2) == 0,
+                    "Repeated submission succeeds");
+    }
+    TEST_ASSERT(stft_async_drain(as) == 0, "Drain after burst succeeds");
+    TEST_ASSERT(st2.frames_seen == 8 * config->outsize,
+                "Every queued batch ran to completion");
+
+    // A batch run against a config that no longer validates marks the
+    // pipeline failed; drain reports it and the flag stays sticky.
+    size_t saved_win = config->win;
+    config->win = 0;
+    TEST_ASSERT(stft_async_submit(as, input, async_out, NULL, NULL) == 0,
+                "Submission against broken config accepted");
+    TEST_ASSERT(stft_async_drain(as) == -1, "Drain reports batch failure");
+    config->win = saved_win;
+    TEST_ASSERT(stft_async_drain(as) == -1, "Failure flag is sticky");
+
+    // Invalid parameter handling
+    TEST_ASSERT(stft_async_submit(NULL, input, async_out, NULL, NULL) == -1,
+                "NULL handle rejected by submit");
+    TEST_ASSERT(stft_async_submit(as, NULL, async_out, NULL, NULL) == -1,
+                "NULL input rejected by submit");
+    TEST_ASSERT(stft_async_drain(NULL) == -1, "NULL handle rejected by drain");
+    TEST_ASSERT(stft_async_init(NULL, 0) == NULL,
+                "NULL config rejected by init");
+
+    stft_async_deinit(as);
+    stft_async_deinit(NULL); // no-op
+
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(async_out[i]);
+        free(sync_out[i]);
+    }
+    free(async_out);
+    free(sync_out);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_nonpow2_fftsize() {
+    TEST_SECTION("Non-Power-of-2 FFT Size Tests");
+
+    // Size selection: 2^a*3^b*5^c with 2^a >= 32 passes through untouched
+    TEST_ASSERT(stft_fft_size(960) == 960, "960 = 2^6*3*5 used directly");
+    TEST_ASSERT(stft_fft_size(480) == 480, "480 = 2^5*3*5 used directly");
+    TEST_ASSERT(stft_fft_size(1024) == 1024, "Power of two used directly");
+    TEST_ASSERT(stft_fft_size(720) == 1024,
+                "720 = 2^4*3^2*5 falls back to nextPow2 (2^a too small)");
+    TEST_ASSERT(stft_fft_size(100) == 128,
+                "100 = 2^2*5^2 falls back to nextPow2");
+    TEST_ASSERT(stft_fft_size(1000) == 1024,
+                "1000 = 2^3*5^3 falls back to nextPow2");
+
+    // A 20 ms frame at 48 kHz runs without zero-padding
+    const size_t hop = 240;
+    const size_t win = 960;
+    const size_t input_size = 9600;
+
+    STFT_Config_t *config =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation with win=960");
+    if (!config)
+        return;
+    TEST_ASSERT(config->fftsize == 960, "Chosen FFT size exposed as 960");
+
+    float *input = (float *)malloc(input_size * sizeof(float));
+    Complex_t **output =
+        (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        output[i] = (Complex_t *)malloc(STFT_BINS(config->fftsize) *
+                                        sizeof(Complex_t));
+    }
+
+    // 500 Hz at 48 kHz lands exactly on bin 10 when fftsize is 960
+    for (size_t i = 0; i < input_size; i++) {
+        input[i] = sinf(2.0f * PI * 500.0f * i / 48000.0f);
+    }
+
+    TEST_ASSERT(stft_compute(config, input, output) == 0,
+                "Compute succeeds with fftsize=960");
+
+    size_t peak_bin = 0;
+    float peak_mag = 0.0f;
+    for (size_t j = 0; j < STFT_BINS(config->fftsize); j++) {
+        float mag = cabs(output[1][j]);
+        if (mag > peak_mag) {
+            peak_mag = mag;
+            peak_bin = j;
+        }
+    }
+    TEST_ASSERT(peak_bin == 10, "500 Hz tone lands on bin 10 exactly");
+
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(output[i]);
+    }
+    free(output);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_stft_stats() {
+    TEST_SECTION("Hot-Path Instrumentation Tests");
+
+    const size_t hop = 128;
+    const size_t win = 512;
+    const size_t input_size = 4096;
+
+    STFT_Config_t *config =
+        stft_config_init(hop, win, input_size, HANNING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Config creation for stats test");
+    if (!config)
+        return;
+
+    float *input = (float *)malloc(input_size * sizeof(float));
+    Complex_t **output =
+        (Complex_t **)malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        output[i] = (Complex_t *)malloc(STFT_BINS(config->fftsize) *
+                                        sizeof(Complex_t));
+    }
+    for (size_t i = 0; i < input_size; i++) {
+        input[i] = sinf(2.0f * PI * 440.0f * i / 8000.0f);
+    }
+
+    // Counters start at zero on a fresh config
+    STFT_Stats_t stats;
+    TEST_ASSERT(stft_stats_snapshot(config, &stats) == 0,
+                "Snapshot on fresh config succeeds");
+    TEST_ASSERT(stats.frames == 0 && stats.cycles_fft == 0 &&
+                    stats.bytes_in == 0,
+                "Fresh config counters start at zero");
+
+    // One compute call populates every counter
+    TEST_ASSERT(stft_compute(config, input, output) == 0,
+                "Compute succeeds with stats enabled");
+    TEST_ASSERT(stft_stats_snapshot(config, &stats) == 0,
+                "Snapshot after compute succeeds");
+    TEST_ASSERT(stats.frames == (uint64_t)config->outsize,
+                "Frame counter matches frames produced");
+    TEST_ASSERT(stats.cycles_gather > 0 && stats.cycles_fft > 0 &&
+                    stats.cycles_unpack > 0,
+                "Per-stage cycle counters advanced");
+    TEST_ASSERT(stats.bytes_out == (uint64_t)config->outsize *
+                                       STFT_BINS(config->fftsize) *
+                                       sizeof(Complex_t),
+                "Output byte counter matches bins written");
+    TEST_ASSERT(stats.hwm_call_bytes > 0 &&
+                    stats.hwm_call_bytes <= stats.bytes_in,
+                "High-water mark tracks the largest call");
+
+    // Counters accumulate across calls
+    TEST_ASSERT(stft_compute(config, input, output) == 0,
+                "Second compute succeeds");
+    STFT_Stats_t stats2;
+    stft_stats_snapshot(config, &stats2);
+    TEST_ASSERT(stats2.frames == 2 * stats.frames,
+                "Counters accumulate across calls");
+
+    // Reset returns everything to zero
+    TEST_ASSERT(stft_stats_reset(config) == 0, "Reset succeeds");
+    stft_stats_snapshot(config, &stats);
+    TEST_ASSERT(stats.frames == 0 && stats.cycles_gather == 0 &&
+                    stats.cycles_fft == 0 && stats.cycles_unpack == 0 &&
+                    stats.bytes_in == 0 && stats.bytes_out == 0 &&
+                    stats.hwm_call_bytes == 0,
+                "Reset zeroes every counter");
+
+    // Invalid parameter handling
+    TEST_ASSERT(stft_stats_snapshot(NULL, &stats) == -1,
+                "NULL config rejected by snapshot");
+    TEST_ASSERT(stft_stats_snapshot(config, NULL) == -1,
+                "NULL output rejected by snapshot");
+    TEST_ASSERT(stft_stats_reset(NULL) == -1, "NULL config rejected by reset");
+
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(output[i]);
+    }
+    free(output);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_stft_double_precision() {
+    TEST_SECTION("Double-Precision STFT Tests");
+
+    const size_t input_size = 4096;
+    const size_t window_size = 512;
+    const size_t hop_size = 256;
+
+    STFT_ConfigD_t *dconfig =
+        stft_config_init_d(hop_size, window_size, input_size, HAMMING);
+    STFT_Config_t *fconfig =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    TEST_ASSERT(dconfig != NULL, "Double-precision config initialization");
+    if (!dconfig || !fconfig)
+        return;
+
+    // Same signal in both precisions
+    float *finput = malloc(input_size * sizeof(float));
+    double *dinput = malloc(input_size * sizeof(double));
+    generate_sine_wave(finput, input_size, 100.0f, 1000.0f);
+    for (size_t i = 0; i < input_size; i++) {
+        dinput[i] = (double)finput[i];
+    }
+
+    size_t bins = STFT_BINS(dconfig->fftsize);
+    Complex_t **fout = malloc(fconfig->outsize * sizeof(Complex_t *));
+    ComplexD_t **dout = malloc(dconfig->outsize * sizeof(ComplexD_t *));
+    for (size_t i = 0; i < dconfig->outsize; i++) {
+        fout[i] = malloc(bins * sizeof(Complex_t));
+        dout[i] = malloc(bins * sizeof(ComplexD_t));
+    }
+
+    stft_compute(fconfig, finput, fout);
+    TEST_ASSERT(stft_compute_d(dconfig, dinput, dout) == 0,
+                "Double-precision STFT computation");
+
+    // Both precisions in one binary must agree to float accuracy
+    bool agree = true;
+    for (size_t i = 0; i < dconfig->outsize && agree; i++) {
+        for (size_t j = 0; j < bins; j++) {
+            double fm = sqrt((double)fout[i][j].re * fout[i][j].re +
+                             (double)fout[i][j].im * fout[i][j].im);
+            double dm = sqrt(dout[i][j].re * dout[i][j].re +
+                             dout[i][j].im * dout[i][j].im);
+            if (fabs(fm - dm) > 1e-2 * (1.0 + dm)) {
+                agree = false;
+                break;
+            }
+        }
+    }
+    TEST_ASSERT(agree, "Float and double spectra agree to float accuracy");
+
+    // DC and Nyquist honor the real-valued bin contract
+    bool edges_real = true;
+    for (size_t i = 0; i < dconfig->outsize; i++) {
+        if (dout[i][0].im != 0.0 || dout[i][bins - 1].im != 0.0)
+            edges_real = false;
+    }
+    TEST_ASSERT(edges_real, "Double DC and Nyquist bins are real-valued");
+
+    TEST_ASSERT(stft_compute_d(NULL, dinput, dout) == -1,
+                "NULL double config rejected");
+
+    for (size_t i = 0; i < dconfig->outsize; i++) {
+        free(fout[i]);
+        free(dout[i]);
+    }
+    free(fout);
+    free(dout);
+    free(finput);
+    free(dinput);
+    stft_config_deinit_d(dconfig);
+    stft_config_deinit(fconfig);
+}
+
+void test_specialized_kernels() {
+    TEST_SECTION("Specialized Kernel Tests");
+
+    const size_t input_size = 8192;
+    const size_t window_size = 512; // win == fftsize: dispatch eligible
+    const size_t hop_size = 256;
+
+    // Generic reference via the batch path (never dispatched)
+    STFT_Config_t *generic = stft_config_init(hop_size, window_size,
+                                              input_size, HAMMING,
+                                              STFT_FFT_BATCH);
+    STFT_Config_t *config =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    if (!generic || !config)
+        return;
+
+    float *input = malloc(input_size * sizeof(float));
+    generate_chirp(input, input_size, 100.0f, 2000.0f, 8000.0f);
+
+    size_t bins = STFT_BINS(config->fftsize);
+    Complex_t **expected = malloc(config->outsize * sizeof(Complex_t *));
+    Complex_t **dispatched = malloc(config->outsize * sizeof(Complex_t *));
+    Complex_t **direct = malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        expected[i] = malloc(bins * sizeof(Complex_t));
+        dispatched[i] = malloc(bins * sizeof(Complex_t));
+        direct[i] = malloc(bins * sizeof(Complex_t));
+    }
+
+    stft_compute(generic, input, expected);
+    TEST_ASSERT(stft_compute(config, input, dispatched) == 0,
+                "Dispatched compute succeeds");
+    TEST_ASSERT(stft_compute_512(config, input, direct) == 0,
+                "Direct specialized call succeeds");
+
+    bool dispatch_ok = true, direct_ok = true;
+    for (size_t i = 0; i < config->outsize; i++) {
+        if (memcmp(dispatched[i], expected[i], bins * sizeof(Complex_t)) != 0)
+            dispatch_ok = false;
+        if (memcmp(direct[i], expected[i], bins * sizeof(Complex_t)) != 0)
+            direct_ok = false;
+    }
+    TEST_ASSERT(dispatch_ok, "Dispatched output matches generic path");
+    TEST_ASSERT(direct_ok, "stft_compute_512 output matches generic path");
+
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(expected[i]);
+        free(dispatched[i]);
+        free(direct[i]);
+    }
+    free(expected);
+    free(dispatched);
+    free(direct);
+    free(input);
+    stft_config_deinit(generic);
+    stft_config_deinit(config);
+
+    // win < fftsize must fall through to the generic loop and still work
+    STFT_Config_t *padded =
+        stft_config_init(hop_size, 300, input_size, HAMMING, STFT_FFT);
+    if (padded) {
+        float *in2 = malloc(input_size * sizeof(float));
+        generate_sine_wave(in2, input_size, 100.0f, 1000.0f);
+        size_t b2 = STFT_BINS(padded->fftsize);
+        Complex_t **out2 = malloc(padded->outsize * sizeof(Complex_t *));
+        for (size_t i = 0; i < padded->outsize; i++) {
+            out2[i] = malloc(b2 * sizeof(Complex_t));
+        }
+        TEST_ASSERT(stft_compute(padded, in2, out2) == 0,
+                    "Zero-padded shape falls back to generic loop");
+        for (size_t i = 0; i < padded->outsize; i++) {
+            free(out2[i]);
+        }
+        free(out2);
+        free(in2);
+        stft_config_deinit(padded);
+    }
+}
+
+void test_half_spectrum_contract() {
+    TEST_SECTION("Half-Spectrum Output Contract Tests");
+
+    const size_t input_size = 2048;
+    const size_t window_size = 512;
+    const size_t hop_size = 256;
+
+    STFT_Config_t *config =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    if (!config)
+        return;
+
+    float *input = malloc(input_size * sizeof(float));
+    generate_sine_wave(input, input_size, 100.0f, 1000.0f);
+
+    size_t bins = STFT_BINS(config->fftsize);
+    Complex_t **output = malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        output[i] = malloc(bins * sizeof(Complex_t));
+    }
+    stft_compute(config, input, output);
+
+    // DC and Nyquist occupy their own bins with zero imaginary part
+    bool edges_real = true;
+    for (size_t i = 0; i < config->outsize; i++) {
+        if (output[i][0].im != 0.0f || output[i][bins - 1].im != 0.0f)
+            edges_real = false;
+    }
+    TEST_ASSERT(edges_real, "DC and Nyquist bins have zero imaginary part");
+
+    // DC bin equals the plain sum of the windowed frame
+    float expected_dc = 0.0f;
+    for (size_t k = 0; k < config->win; k++) {
+        expected_dc += input[k] * config->winvals[k];
+    }
+    TEST_ASSERT(fabsf(output[0][0].re - expected_dc) <
+                    1e-3f * (1.0f + fabsf(expected_dc)),
+                "DC bin matches windowed frame sum");
+
+    // Pack/unpack round-trips the ordered layout exactly
+    float *packed = malloc(config->fftsize * sizeof(float));
+    Complex_t *row = malloc(bins * sizeof(Complex_t));
+    stft_pack_spectrum(output[0], packed, config->fftsize);
+    stft_unpack_spectrum(packed, row, config->fftsize);
+    TEST_ASSERT(memcmp(row, output[0], bins * sizeof(Complex_t)) == 0,
+                "pack/unpack round-trip is exact");
+    free(packed);
+    free(row);
+
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(output[i]);
+    }
+    free(output);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_config_arena() {
+    TEST_SECTION("Config Arena Layout Tests");
+
+    STFT_Config_t *config =
+        stft_config_init(256, 512, 4096, HAMMING, STFT_FFT);
+    if (!config)
+        return;
+
+    // Every carved buffer starts on an STFT_ARENA_ALIGN boundary
+    TEST_ASSERT((uintptr_t)config % STFT_ARENA_ALIGN == 0 &&
+                    (uintptr_t)config->winvals % STFT_ARENA_ALIGN == 0 &&
+                    (uintptr_t)config->input % STFT_ARENA_ALIGN == 0 &&
+                    (uintptr_t)config->work % STFT_ARENA_ALIGN == 0 &&
+                    (uintptr_t)config->output % STFT_ARENA_ALIGN == 0,
+                "Arena regions aligned");
+
+    // The window copy sits directly before the FFT input buffer
+    size_t fbytes = STFT_ARENA_ROUND(sizeof(float) * config->fftsize);
+    TEST_ASSERT((char *)config->input == (char *)config->winvals + fbytes,
+                "Window table adjacent to input buffer");
+    TEST_ASSERT((char *)config->work == (char *)config->input + fbytes &&
+                    (char *)config->output == (char *)config->work + fbytes,
+                "Buffers contiguous in one block");
+
+    // The arena copy matches the shared cached window
+    bool coeffs_ok = true;
+    for (size_t i = 0; i < config->fftsize; i++) {
+        if (config->winvals[i] != config->pwin->fvalues[i])
+            coeffs_ok = false;
+    }
+    TEST_ASSERT(coeffs_ok, "Arena window copy matches cached coefficients");
+
+    stft_config_deinit(config);
+
+    // Sliding mode carves the history buffer from the same arena
+    STFT_Config_t *sliding =
+        stft_config_init(128, 512, 0, HAMMING, STFT_SLIDING);
+    if (sliding) {
+        TEST_ASSERT((char *)sliding->history ==
+                        (char *)sliding->output +
+                            STFT_ARENA_ROUND(sizeof(float) *
+                                             sliding->fftsize),
+                    "History buffer carved from arena");
+        stft_config_deinit(sliding);
+    }
+}
+
+void test_setup_window_cache() {
+    TEST_SECTION("Setup/Window Cache Tests");
+
+    const size_t input_size = 4096;
+
+    // Two configs with identical geometry share one setup and one window
+    STFT_Config_t *a =
+        stft_config_init(256, 512, input_size, HAMMING, STFT_FFT);
+    STFT_Config_t *b =
+        stft_config_init(128, 512, input_size, HAMMING, STFT_FFT);
+    if (!a || !b)
+        return;
+
+    TEST_ASSERT(a->setup == b->setup, "Same fftsize shares one PFFFT setup");
+    TEST_ASSERT(a->pwin == b->pwin,
+                "Same (fftsize, type) shares one window table");
+
+    // Different size or window type must not alias
+    STFT_Config_t *c =
+        stft_config_init(256, 1024, input_size, HAMMING, STFT_FFT);
+    STFT_Config_t *d =
+        stft_config_init(256, 512, input_size, HANNING, STFT_FFT);
+    if (c && d) {
+        TEST_ASSERT(c->setup != a->setup, "Different fftsize gets own setup");
+        TEST_ASSERT(d->pwin != a->pwin, "Different window type gets own table");
+        TEST_ASSERT(d->setup == a->setup,
+                    "Setup cache keyed by fftsize only, not window type");
+    }
+
+    // Plans consult the same cache as configs
+    STFT_Plan_t *plan = stft_plan_init(256, 512, HAMMING);
+    if (plan) {
+        TEST_ASSERT(plan->setup == a->setup, "Plan reuses cached setup");
+        TEST_ASSERT(plan->pwin == a->pwin, "Plan reuses cached window");
+        stft_plan_deinit(plan);
+    }
+
+    // Releasing one holder must leave the survivors fully usable
+    stft_config_deinit(a);
+
+    float *input = malloc(input_size * sizeof(float));
+    generate_sine_wave(input, input_size, 100.0f, 1000.0f);
+    Complex_t **output = malloc(b->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < b->outsize; i++) {
+        output[i] = malloc(STFT_BINS(b->fftsize) * sizeof(Complex_t));
+    }
+    TEST_ASSERT(stft_compute(b, input, output) == 0,
+                "Surviving config computes after peer release");
+
+    for (size_t i = 0; i < b->outsize; i++) {
+        free(output[i]);
+    }
+    free(output);
+    free(input);
+
+    stft_config_deinit(b);
+    if (c)
+        stft_config_deinit(c);
+    if (d)
+        stft_config_deinit(d);
+
+    // After all holders are gone a fresh init must repopulate the cache
+    STFT_Config_t *e =
+        stft_config_init(256, 512, input_size, HAMMING, STFT_FFT);
+    TEST_ASSERT(e != NULL, "Cache repopulates after full release");
+    if (e)
+        stft_config_deinit(e);
+}
+
+void test_stft_plan() {
+    TEST_SECTION("Reusable Plan Tests");
+
+    const size_t window_size = 512;
+    const size_t hop_size = 256;
+
+    STFT_Plan_t *plan = stft_plan_init(hop_size, window_size, HAMMING);
+    TEST_ASSERT(plan != NULL, "Plan created");
+    if (!plan)
+        return;
+
+    TEST_ASSERT(stft_plan_outsize(plan, 2048) == 7,
+                "Outsize derived per call (2048 samples)");
+    TEST_ASSERT(stft_plan_outsize(plan, 4096) == 15,
+                "Outsize derived per call (4096 samples)");
+    TEST_ASSERT(stft_plan_outsize(plan, window_size - 1) == 0,
+                "Input shorter than window gives zero frames");
+
+    // One plan, two different input lengths, results match per-length configs
+    size_t lengths[] = {2048, 4096};
+    for (int l = 0; l < 2; l++) {
+        size_t insize = lengths[l];
+        STFT_Config_t *config = stft_config_init(hop_size, window_size, insize,
+                                                 HAMMING, STFT_FFT);
+        if (!config)
+            continue;
+
+        float *input = malloc(insize * sizeof(float));
+        generate_sine_wave(input, insize, 100.0f, 1000.0f);
+
+        size_t outsize = stft_plan_outsize(plan, insize);
+        Complex_t **expected = malloc(outsize * sizeof(Complex_t *));
+        Complex_t **actual = malloc(outsize * sizeof(Complex_t *));
+        for (size_t i = 0; i < outsize; i++) {
+            expected[i] = malloc(STFT_BINS(plan->fftsize) * sizeof(Complex_t));
+            actual[i] = malloc(STFT_BINS(plan->fftsize) * sizeof(Complex_t));
+        }
+
+        stft_compute(config, input, expected);
+        TEST_ASSERT(stft_execute(plan, input, insize, actual) == 0,
+                    "Plan execution");
+
+        bool identical = true;
+        for (size_t i = 0; i < outsize; i++) {
+            if (memcmp(expected[i], actual[i],
+                       STFT_BINS(plan->fftsize) * sizeof(Complex_t)) != 0) {
+                identical = false;
+            }
+        }
+        TEST_ASSERT(identical, "Plan output matches config output");
+
+        for (size_t i = 0; i < outsize; i++) {
+            free(expected[i]);
+            free(actual[i]);
+        }
+        free(expected);
+        free(actual);
+        free(input);
+        stft_config_deinit(config);
+    }
+
+    TEST_ASSERT(stft_execute(plan, NULL, 2048, NULL) == -1,
+                "Null input rejected");
+
+    stft_plan_deinit(plan);
+}
+
+void test_stft_writer() {
+    TEST_SECTION("Streaming Spectrogram Writer Tests");
+
+    const size_t input_size = 2048;
+    const size_t window_size = 512;
+    const size_t hop_size = 256;
+    const char *path = "/tmp/stft_test_spectrogram.bin";
+
+    STFT_Config_t *config =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    if (!config)
+        return;
+
+    float *input = malloc(input_size * sizeof(float));
+    generate_sine_wave(input, input_size, 100.0f, 1000.0f);
+
+    Complex_t **output = malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        output[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
+    }
+    stft_compute(config, input, output);
+
+    // Stream frames to disk one at a time
+    STFT_Writer_t *writer = stft_writer_open(path, config);
+    TEST_ASSERT(writer != NULL, "Writer opened");
+    if (writer) {
+        bool append_ok = true;
+        for (size_t i = 0; i < config->outsize; i++) {
+            if (stft_writer_append(writer, output[i]) != 0) {
+                append_ok = false;
+            }
+        }
+        TEST_ASSERT(append_ok, "All frames appended");
+        TEST_ASSERT(stft_writer_close(writer) == 0, "Writer closed");
+    }
+
+    // Read it back: header then seekable fixed-size frames
+    FILE *fp = fopen(path, "rb");
+    TEST_ASSERT(fp != NULL, "Spectrogram file readable");
+    if (fp) {
+        STFT_FileHeader_t header;
+        TEST_ASSERT(fread(&header, sizeof(header), 1, fp) == 1, "Header read");
+        TEST_ASSERT(header.magic == STFT_FILE_MAGIC, "Magic matches");
+        TEST_ASSERT(header.version == STFT_FILE_VERSION, "Version matches");
+        TEST_ASSERT(header.fftsize == config->fftsize &&
+                        header.hop == config->hop && header.win == config->win,
+                    "Geometry recorded in header");
+        TEST_ASSERT(header.nframes == config->outsize,
+                    "Frame count finalized on close");
+
+        // Random-seek the last frame by index
+        Complex_t *frame = malloc(header.bins * sizeof(Complex_t));
+        long offset = (long)sizeof(header) +
+                      (long)(header.nframes - 1) * header.bins *
+                          (long)sizeof(Complex_t);
+        fseek(fp, offset, SEEK_SET);
+        TEST_ASSERT(fread(frame, sizeof(Complex_t), header.bins, fp) ==
+                        header.bins,
+                    "Last frame read by index");
+        TEST_ASSERT(memcmp(frame, output[config->outsize - 1],
+                           header.bins * sizeof(Complex_t)) == 0,
+                    "Seeked frame matches computed frame");
+        free(frame);
+        fclose(fp);
+    }
+
+    TEST_ASSERT(stft_writer_append(NULL, output[0]) == -1,
+                "Null writer rejected");
+
+    // Cleanup
+    remove(path);
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(output[i]);
+    }
+    free(output);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_stft_parallel() {
+    TEST_SECTION("Parallel STFT Tests");
+
+    const size_t input_size = 16384;
+    const size_t window_size = 512;
+    const size_t hop_size = 128;
+
+    STFT_Config_t *config =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    TEST_ASSERT(config != NULL, "Configuration created for parallel test");
+    if (!config)
+        return;
+
+    float *input = malloc(input_size * sizeof(float));
+    generate_chirp(input, input_size, 50.0f, 2000.0f, 8000.0f);
+
+    Complex_t **serial = malloc(config->outsize * sizeof(Complex_t *));
+    Complex_t **parallel = malloc(config->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < config->outsize; i++) {
+        serial[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
+        parallel[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
+    }
+
+    TEST_ASSERT(stft_compute(config, input, serial) == 0,
+                "Serial reference computation");
+    TEST_ASSERT(stft_compute_parallel(config, input, parallel, 4) == 0,
+                "Parallel computation with 4 threads");
+
+    bool identical = true;
+    for (size_t i = 0; i < config->outsize; i++) {
+        if (memcmp(serial[i], parallel[i],
+                   STFT_BINS(config->fftsize) * sizeof(Complex_t)) != 0) {
+            identical = false;
+        }
+    }
+    TEST_ASSERT(identical, "Parallel output matches serial output");
+
+    // Default thread count (0 = number of online CPUs)
+    TEST_ASSERT(stft_compute_parallel(config, input, parallel, 0) == 0,
+                "Parallel computation with default thread count");
+
+    TEST_ASSERT(stft_compute_parallel(NULL, input, parallel, 4) == -1,
+                "Null config rejected");
+
+    // Cleanup
+    for (size_t i = 0; i < config->outsize; i++) {
+        free(serial[i]);
+        free(parallel[i]);
+    }
+    free(serial);
+    free(parallel);
+    free(input);
+    stft_config_deinit(config);
+}
+
+void test_stft_sliding_mode() {
+    TEST_SECTION("Sliding Mode STFT Tests");
+
+    const size_t input_size = 2048;
+    const size_t window_size = 512;
+    const size_t hop_size = 128;
+
+    // Batch reference
+    STFT_Config_t *batch =
+        stft_config_init(hop_size, window_size, input_size, HAMMING, STFT_FFT);
+    // Sliding engine (length-independent)
+    STFT_Config_t *sliding = stft_config_init(hop_size, window_size, 0, HAMMING,
+                                              STFT_SLIDING);
+    TEST_ASSERT(batch != NULL, "Batch configuration created");
+    TEST_ASSERT(sliding != NULL, "Sliding configuration created");
+
+    if (!batch || !sliding) {
+        stft_config_deinit(batch);
+        stft_config_deinit(sliding);
+        return;
+    }
+
+    float *input = malloc(input_size * sizeof(float));
+    generate_sine_wave(input, input_size, 100.0f, 1000.0f);
+
+    // stft_compute must reject a sliding config
+    Complex_t *frame = malloc(STFT_BINS(batch->fftsize) * sizeof(Complex_t));
+    TEST_ASSERT(stft_compute(sliding, input, NULL) == -1,
+                "stft_compute rejects STFT_SLIDING config");
+    TEST_ASSERT(stft_push(batch, input, frame) == -1,
+                "stft_push rejects STFT_FFT config");
+    TEST_ASSERT(stft_push(sliding, NULL, frame) == -1,
+                "stft_push rejects null input");
+
+    // Batch reference frames
+    Complex_t **reference = malloc(batch->outsize * sizeof(Complex_t *));
+    for (size_t i = 0; i < batch->outsize; i++) {
+        reference[i] = malloc(STFT_BINS(batch->fftsize) * sizeof(Complex_t));
+    }
+    stft_compute(batch, input, reference);
+
+    // Push hop by hop; after win/hop pushes the history holds exactly
+    // input[0..win), i.e. batch frame 0, and each further push advances
+    // one batch frame.
+    size_t priming = window_size / hop_size;
+    size_t num_hops = input_size / hop_size;
+    bool frames_match = true;
+
+    for (size_t h = 0; h < num_hops; h++) {
+        int result = stft_push(sliding, input + h * hop_size, frame);
+        if (result != 0) {
+            frames_match = false;
+            break;
+        }
+        if (h + 1 >= priming) {
+            size_t batch_idx = h + 1 - priming;
+            if (batch_idx < batch->outsize) {
+                for (size_t j = 0; j < STFT_BINS(batch->fftsize); j++) {
+                    if (fabsf(frame[j].re - reference[batch_idx][j].re) >
+                            1e-3f ||
+                        fabsf(frame[j].im - reference[batch_idx][j].im) >
+                            1e-3f) {
+                        frames_match = false;
+                    }
+                }
+            }
+        }
+    }
+
+    TEST_ASSERT(frames_match, "Sliding frames match batch frames");
+
+    // Reset clears the history: a zero push after reset gives zero output
+    TEST_ASSERT(stft_reset(sliding) == 0, "Sliding history reset");
+    float *zeros = calloc(window_size, sizeof(float));
+    bool near_zero = true;
+    for (size_t h = 0; h < priming; h++) {
+        stft_push(sliding, zeros, frame);
+    }
+    for (size_t j = 0; j < STFT_BINS(batch->fftsize); j++) {
+        if (cabs(frame[j]) > TEST_TOLERANCE) {
+            near_zero = false;
+        }
+    }
+    TEST_ASSERT(near_zero, "Zero pushes after reset give zero frame");
+
+    // Cleanup
+    for (size_t i = 0; i < batch->outsize; i++) {
+        free(reference[i]);
+    }
+    free(reference);
+    free(zeros);
+    free(frame);
+    free(input);
+    stft_config_deinit(batch);
+    stft_config_deinit(sliding);
+}
+
 void test_performance() {
     TEST_SECTION("Performance Tests");
 
@@ -414,7 +2590,7 @@ void test_performance() {
         // Allocate output
         Complex_t **output = malloc(config->outsize * sizeof(Complex_t *));
         for (size_t j = 0; j < config->outsize; j++) {
-            output[j] = malloc(config->fftsize * sizeof(Complex_t));
+            output[j] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
         }
 
         // Performance measurement
@@ -475,7 +2651,7 @@ void test_memory_stress() {
             Complex_t **output =
                 malloc(configs[i]->outsize * sizeof(Complex_t *));
             for (size_t j = 0; j < configs[i]->outsize; j++) {
-                output[j] = malloc(configs[i]->fftsize * sizeof(Complex_t));
+                output[j] = malloc(STFT_BINS(configs[i]->fftsize) * sizeof(Complex_t));
             }
 
             int result = stft_compute(configs[i], input, output);
@@ -520,7 +2696,7 @@ void test_chirp_signal() {
     // Allocate output
     Complex_t **output = malloc(config->outsize * sizeof(Complex_t *));
     for (size_t i = 0; i < config->outsize; i++) {
-        output[i] = malloc(config->fftsize * sizeof(Complex_t));
+        output[i] = malloc(STFT_BINS(config->fftsize) * sizeof(Complex_t));
     }
 
     // Compute STFT
@@ -535,7 +2711,7 @@ void test_chirp_signal() {
         float max_magnitude = 0.0f;
         size_t max_bin = 0;
 
-        for (size_t j = 1; j < config->fftsize / 2; j++) {
+        for (size_t j = 1; j < STFT_BINS(config->fftsize); j++) {
             float magnitude = cabs(output[i][j]);
             if (magnitude > max_magnitude) {
                 max_magnitude = magnitude;
@@ -594,6 +2770,35 @@ int main() {
     test_stft_edge_cases();
     test_stft_different_window_types();
     test_chirp_signal();
+    test_stft_batch_mode();
+    test_window_float_coefficients();
+    test_gather_window_kernel();
+    test_stft_flat_output();
+    test_stft_mmap_input();
+    test_stft_spectra_outputs();
+    test_istft_roundtrip();
+    test_checked_unchecked_api();
+    test_filterbank();
+    test_cpu_dispatch();
+    test_sparse_bins();
+    test_overlap_compute();
+    test_window_recurrence();
+    test_window_bank_lookup();
+    test_bulk_complex_ops();
+    test_ring_frontend();
+    test_multichannel();
+    test_async_pipeline();
+    test_nonpow2_fftsize();
+    test_stft_stats();
+    test_stft_double_precision();
+    test_specialized_kernels();
+    test_half_spectrum_contract();
+    test_config_arena();
+    test_setup_window_cache();
+    test_stft_plan();
+    test_stft_writer();
+    test_stft_parallel();
+    test_stft_sliding_mode();
     test_memory_stress();
     test_performance();
 
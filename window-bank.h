@@ -38,11 +38,24 @@
 /**
  * @brief Type used for window values (can be changed to float, long double,
  * etc.).
+ *
+ * This only affects the `values` array. Every window additionally carries
+ * a `fvalues` float array (see Window), so hot loops get a fixed, aligned
+ * float layout no matter which translation unit included this header
+ * first or what WTYPE was defined to.
  */
 #ifndef WTYPE
 #define WTYPE double
 #endif // WTYPE
 
+/**
+ * @brief Alignment in bytes of the `fvalues` coefficient array
+ * (compatible with pffft_aligned_malloc buffers).
+ */
+#ifndef WINDOW_ALIGN
+#define WINDOW_ALIGN 64
+#endif // WINDOW_ALIGN
+
 /**
  * @brief Pi constant used in window calculations.
  */
@@ -52,6 +65,8 @@
 
 #include <assert.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -71,19 +86,39 @@ typedef enum WinType {
  * @brief Represents a single window of a given size and type.
  */
 typedef struct Window {
-    int size;      /**< Number of elements in the window */
-    WTYPE *values; /**< Pointer to array of window values */
-    WinType type;  /**< Type of the window function */
+    int size;       /**< Number of elements in the window */
+    WTYPE *values;  /**< Pointer to array of window values */
+    float *fvalues; /**< SIMD-aligned float copy of the coefficients */
+    WinType type;   /**< Type of the window function */
 } Window;
 
+/**
+ * @struct WindowIndex
+ * @brief Immutable size-sorted snapshot of a bank's windows.
+ *
+ * Lookups binary-search one snapshot, so a reader never observes a
+ * half-updated table. Growing the bank (window_bank_get_or_create)
+ * publishes a fresh snapshot and retires the old one on the `prev`
+ * chain, where it stays valid for readers still using it until the
+ * bank is deinitialized.
+ */
+typedef struct WindowIndex {
+    int count;                /**< Number of windows in this snapshot */
+    Window **pwins;           /**< Windows sorted by size, ascending */
+    struct WindowIndex *prev; /**< Retired snapshots (freed at deinit) */
+} WindowIndex;
+
 /**
  * @struct WindowBank
  * @brief Holds multiple windows of the same type with varying sizes.
+ *
+ * Reads (window_bank_get) are lock-free constant-time binary searches
+ * over the current snapshot; only writers take the lock.
  */
 typedef struct WindowBank {
-    int count;      /**< Number of windows */
-    Window **pwins; /**< Array of pointers to Window structures */
-    WinType type;   /**< Type of all windows in the bank */
+    WinType type;                 /**< Type of all windows in the bank */
+    _Atomic(WindowIndex *) index; /**< Current published snapshot */
+    pthread_mutex_t lock;         /**< Serializes get_or_create writers */
 } WindowBank;
 
 /**
@@ -163,6 +198,10 @@ int window_bank_fill(WindowBank *pwb);
 
 /**
  * @brief Get a window of a specific size from a WindowBank.
+ *
+ * O(log n) binary search over the current size-sorted snapshot; safe to
+ * call from any number of threads concurrently with get_or_create.
+ *
  * @param pwb Pointer to WindowBank.
  * @param size Desired window size.
  * @return Pointer to Window with matching size, or NULL if not found.
@@ -170,79 +209,110 @@ int window_bank_fill(WindowBank *pwb);
 Window *window_bank_get(WindowBank *pwb, int size);
 
 /**
- * @brief Fill a Hanning window of given size.
+ * @brief Get a window of a specific size, creating and filling it once
+ * if the bank does not hold it yet.
+ *
+ * The hit path is identical to window_bank_get (lock-free). A miss
+ * takes the bank's writer lock, builds the missing window, and
+ * publishes a new sorted snapshot; concurrent readers keep using the
+ * old snapshot until they next look up.
+ *
+ * @param pwb Pointer to WindowBank.
+ * @param size Desired window size.
+ * @return Pointer to Window with matching size, or NULL on failure.
  */
-int fill_hanning(int size, WTYPE *out) {
+Window *window_bank_get_or_create(WindowBank *pwb, int size);
+
+/**
+ * @brief Steps between exact re-syncs of the cos/sin recurrence.
+ *
+ * The angle-addition recurrence drifts by O(eps) per step; recomputing
+ * the state from libm every WINDOW_RESYNC points keeps the accumulated
+ * error near machine precision while still amortizing the
+ * transcendental calls away.
+ */
+#ifndef WINDOW_RESYNC
+#define WINDOW_RESYNC 256
+#endif // WINDOW_RESYNC
+
+/**
+ * @brief Fill a generalized cosine-sum window incrementally.
+ *
+ * Computes out[i] = a0 - a1*cos(d*i) + a2*cos(2*d*i) + a3*cos(3*d*i)
+ * with d = 2*PI/(size-1), using the angle-addition recurrence
+ *   cos(t+d) = cos(t)*cos(d) - sin(t)*sin(d)
+ *   sin(t+d) = sin(t)*cos(d) + cos(t)*sin(d)
+ * per harmonic — two multiplies and an add per point instead of up to
+ * three libm cos calls — with a periodic exact re-sync (WINDOW_RESYNC)
+ * so the result matches direct evaluation to machine precision.
+ */
+static int fill_cosine_sum(int size, WTYPE a0, WTYPE a1, WTYPE a2, WTYPE a3,
+                           WTYPE *out) {
     if (out == NULL)
         return -1;
 
     assert(size > 1);
 
+    const WTYPE d = 2.0 * PI / (size - 1);
+    const WTYPE cd1 = cos(d), sd1 = sin(d);
+    const WTYPE cd2 = cos(2.0 * d), sd2 = sin(2.0 * d);
+    const WTYPE cd3 = cos(3.0 * d), sd3 = sin(3.0 * d);
+
+    WTYPE c1 = 1.0, s1 = 0.0;
+    WTYPE c2 = 1.0, s2 = 0.0;
+    WTYPE c3 = 1.0, s3 = 0.0;
+
     for (int i = 0; i < size; i++) {
-        out[i] = 0.5 - 0.5 * cos(2.0 * PI * i / (size - 1));
+        if (i > 0 && (i % WINDOW_RESYNC) == 0) {
+            c1 = cos(d * i), s1 = sin(d * i);
+            c2 = cos(2.0 * d * i), s2 = sin(2.0 * d * i);
+            c3 = cos(3.0 * d * i), s3 = sin(3.0 * d * i);
+        }
+
+        out[i] = a0 - a1 * c1 + a2 * c2 + a3 * c3;
+
+        WTYPE t;
+        t = c1 * cd1 - s1 * sd1;
+        s1 = s1 * cd1 + c1 * sd1;
+        c1 = t;
+        t = c2 * cd2 - s2 * sd2;
+        s2 = s2 * cd2 + c2 * sd2;
+        c2 = t;
+        t = c3 * cd3 - s3 * sd3;
+        s3 = s3 * cd3 + c3 * sd3;
+        c3 = t;
     }
 
     return 0;
 }
 
+/**
+ * @brief Fill a Hanning window of given size.
+ */
+int fill_hanning(int size, WTYPE *out) {
+    return fill_cosine_sum(size, 0.5, 0.5, 0.0, 0.0, out);
+}
+
 /**
  * @brief Fill a Hamming window of given size.
  */
 int fill_hamming(int size, WTYPE *out) {
-    if (out == NULL)
-        return -1;
-
-    assert(size > 1);
-
-    for (int i = 0; i < size; i++) {
-        out[i] = (25.0 / 46.0) - (21.0 / 46.0) * cos(2.0 * PI * i / (size - 1));
-    }
-
-    return 0;
+    return fill_cosine_sum(size, 25.0 / 46.0, 21.0 / 46.0, 0.0, 0.0, out);
 }
 
 /**
  * @brief Fill a Blackman window using standard Blackman coefficients.
  */
 int fill_blakman(int size, WTYPE *out) {
-    if (out == NULL)
-        return -1;
-
-    assert(size > 1);
-
-    const WTYPE a0 = 7938.0 / 18608.0;
-    const WTYPE a1 = 9240.0 / 18608.0;
-    const WTYPE a2 = 1430.0 / 18608.0;
-
-    for (int i = 0; i < size; i++) {
-        out[i] = a0 - a1 * cos(2.0 * PI * i / (size - 1)) +
-                 a2 * cos(4.0 * PI * i / (size - 1));
-    }
-
-    return 0;
+    return fill_cosine_sum(size, 7938.0 / 18608.0, 9240.0 / 18608.0,
+                           1430.0 / 18608.0, 0.0, out);
 }
 
 /**
  * @brief Fill a Blackman-Harris window using standard coefficients.
  */
 int fill_blkmhar(int size, WTYPE *out) {
-    if (out == NULL)
-        return -1;
-
-    assert(size > 1);
-
-    const WTYPE a0 = 0.35875;
-    const WTYPE a1 = 0.48829;
-    const WTYPE a2 = 0.14128;
-    const WTYPE a3 = 0.01168;
-
-    for (int i = 0; i < size; i++) {
-        out[i] = a0 - a1 * cos(2.0 * PI * i / (size - 1)) +
-                 a2 * cos(4.0 * PI * i / (size - 1)) +
-                 a3 * cos(6.0 * PI * i / (size - 1));
-    }
-
-    return 0;
+    return fill_cosine_sum(size, 0.35875, 0.48829, 0.14128, 0.01168, out);
 }
 
 /**
@@ -261,6 +331,13 @@ Window *window_init(int size, WinType type) {
         free(pwin);
         return NULL;
     }
+    pwin->fvalues = NULL;
+    if (posix_memalign((void **)&pwin->fvalues, WINDOW_ALIGN,
+                       sizeof(float) * size) != 0) {
+        free(pwin->values);
+        free(pwin);
+        return NULL;
+    }
     return pwin;
 }
 
@@ -272,26 +349,75 @@ void window_deinit(Window *pwin) {
         if (pwin->values) {
             free(pwin->values);
         }
+        if (pwin->fvalues) {
+            free(pwin->fvalues);
+        }
         free(pwin);
     }
 }
 
 /**
  * @brief Fill window values using its specified type.
+ *
+ * Fills the WTYPE `values` array, then mirrors it into the aligned float
+ * `fvalues` array used by vectorized consumers.
  */
 int window_fill(Window *pwin) {
+    int ret = -1;
     if (pwin) {
         if (pwin->type == HANNING) {
-            return fill_hanning(pwin->size, pwin->values);
+            ret = fill_hanning(pwin->size, pwin->values);
         } else if (pwin->type == HAMMING) {
-            return fill_hamming(pwin->size, pwin->values);
+            ret = fill_hamming(pwin->size, pwin->values);
         } else if (pwin->type == BLACKMAN) {
-            return fill_blakman(pwin->size, pwin->values);
+            ret = fill_blakman(pwin->size, pwin->values);
         } else if (pwin->type == BLACKMAN_HARRIS) {
-            return fill_blkmhar(pwin->size, pwin->values);
+            ret = fill_blkmhar(pwin->size, pwin->values);
+        }
+        if (ret == 0 && pwin->fvalues) {
+            for (int i = 0; i < pwin->size; i++) {
+                pwin->fvalues[i] = (float)pwin->values[i];
+            }
         }
     }
-    return -1;
+    return ret;
+}
+
+/**
+ * @brief Allocate a snapshot holding `count` window slots.
+ */
+static WindowIndex *window_index_init(int count) {
+    WindowIndex *idx = (WindowIndex *)malloc(sizeof(WindowIndex));
+    if (idx == NULL)
+        return NULL;
+    idx->count = count;
+    idx->prev = NULL;
+    idx->pwins = (Window **)malloc(sizeof(Window *) * count);
+    if (idx->pwins == NULL) {
+        free(idx);
+        return NULL;
+    }
+    memset(idx->pwins, 0, sizeof(Window *) * count);
+    return idx;
+}
+
+/**
+ * @brief Binary search a snapshot for a window of the given size.
+ */
+static Window *window_index_find(const WindowIndex *idx, int size) {
+    int lo = 0;
+    int hi = idx->count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        Window *pwin = idx->pwins[mid];
+        if (pwin->size == size)
+            return pwin;
+        if (pwin->size < size)
+            lo = mid + 1;
+        else
+            hi = mid - 1;
+    }
+    return NULL;
 }
 
 /**
@@ -303,38 +429,67 @@ WindowBank *window_bank_init(int count, int *sizes, WinType type) {
     WindowBank *pwb = (WindowBank *)malloc(sizeof(WindowBank));
     if (pwb == NULL)
         return NULL;
-    pwb->count = count;
     pwb->type = type;
-    pwb->pwins = (Window **)malloc(sizeof(Window *) * count);
-    if (pwb->pwins == NULL) {
+    pthread_mutex_init(&pwb->lock, NULL);
+
+    WindowIndex *idx = window_index_init(count);
+    if (idx == NULL) {
         free(pwb);
         return NULL;
     }
-    // initialize the memory with null pointers
-    memset(pwb->pwins, 0, sizeof(Window *) * count);
+    atomic_store(&pwb->index, idx);
+
+    // sorted copy of the sizes so the snapshot supports binary search
+    int *sorted = (int *)malloc(sizeof(int) * count);
+    if (sorted == NULL) {
+        window_bank_deinit(pwb);
+        return NULL;
+    }
+    memcpy(sorted, sizes, sizeof(int) * count);
+    for (int i = 1; i < count; i++) {
+        int key = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > key) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = key;
+    }
+
     for (int i = 0; i < count; i++) {
-        int size = sizes[i];
-        Window *pwin = window_init(size, type);
+        Window *pwin = window_init(sorted[i], type);
         if (pwin == NULL) {
+            free(sorted);
             window_bank_deinit(pwb);
             return NULL;
         }
-        pwb->pwins[i] = pwin;
+        idx->pwins[i] = pwin;
     }
+    free(sorted);
     return pwb;
 }
 
 /**
  * @brief Deinitialize a window bank and free all windows.
+ *
+ * Frees the windows of the current snapshot (which holds every window
+ * ever created for the bank) plus the retired snapshot arrays.
  */
 void window_bank_deinit(WindowBank *pwb) {
     if (pwb) {
-        if (pwb->pwins) {
-            for (int i = 0; i < pwb->count; i++) {
-                window_deinit(pwb->pwins[i]);
+        WindowIndex *idx = atomic_load(&pwb->index);
+        if (idx) {
+            for (int i = 0; i < idx->count; i++) {
+                window_deinit(idx->pwins[i]);
             }
-            free(pwb->pwins);
         }
+        while (idx) {
+            WindowIndex *prev = idx->prev;
+            free(idx->pwins);
+            free(idx);
+            idx = prev;
+        }
+        pthread_mutex_destroy(&pwb->lock);
         free(pwb);
     }
 }
@@ -344,9 +499,10 @@ void window_bank_deinit(WindowBank *pwb) {
  */
 int window_bank_fill(WindowBank *pwb) {
     if (pwb) {
-        if (pwb->pwins) {
-            for (int i = 0; i < pwb->count; i++) {
-                if (window_fill(pwb->pwins[i]) != 0)
+        WindowIndex *idx = atomic_load(&pwb->index);
+        if (idx) {
+            for (int i = 0; i < idx->count; i++) {
+                if (window_fill(idx->pwins[i]) != 0)
                     return -1;
             }
             return 0;
@@ -360,17 +516,63 @@ int window_bank_fill(WindowBank *pwb) {
  */
 Window *window_bank_get(WindowBank *pwb, int size) {
     if (pwb) {
-        if (pwb->pwins) {
-            for (int i = 0; i < pwb->count; i++) {
-                Window *pwin = pwb->pwins[i];
-                if (pwin) {
-                    if (pwin->size == size)
-                        return pwin;
-                }
-            }
-        }
+        WindowIndex *idx = atomic_load(&pwb->index);
+        if (idx)
+            return window_index_find(idx, size);
     }
     return NULL;
 }
 
+/**
+ * @brief Retrieve a window of specific size, lazily creating it once.
+ */
+Window *window_bank_get_or_create(WindowBank *pwb, int size) {
+    if (pwb == NULL || size <= 1)
+        return NULL;
+
+    Window *pwin = window_bank_get(pwb, size);
+    if (pwin)
+        return pwin;
+
+    pthread_mutex_lock(&pwb->lock);
+
+    // another writer may have created it while we waited for the lock
+    WindowIndex *idx = atomic_load(&pwb->index);
+    pwin = window_index_find(idx, size);
+    if (pwin) {
+        pthread_mutex_unlock(&pwb->lock);
+        return pwin;
+    }
+
+    pwin = window_init(size, pwb->type);
+    if (pwin == NULL || window_fill(pwin) != 0) {
+        window_deinit(pwin);
+        pthread_mutex_unlock(&pwb->lock);
+        return NULL;
+    }
+
+    WindowIndex *fresh = window_index_init(idx->count + 1);
+    if (fresh == NULL) {
+        window_deinit(pwin);
+        pthread_mutex_unlock(&pwb->lock);
+        return NULL;
+    }
+
+    // merge the new window into its sorted position
+    int pos = 0;
+    while (pos < idx->count && idx->pwins[pos]->size < size)
+        pos++;
+    memcpy(fresh->pwins, idx->pwins, sizeof(Window *) * pos);
+    fresh->pwins[pos] = pwin;
+    memcpy(fresh->pwins + pos + 1, idx->pwins + pos,
+           sizeof(Window *) * (idx->count - pos));
+
+    // retire the old snapshot (readers may still hold it) and publish
+    fresh->prev = idx;
+    atomic_store(&pwb->index, fresh);
+
+    pthread_mutex_unlock(&pwb->lock);
+    return pwin;
+}
+
 #endif // WINDOW_BANK_H_